@@ -1,10 +1,402 @@
 using GLib;
 
-void main ()
+[CCode (lower_case_cprefix = "cscoin_")]
+namespace CSCoin
 {
-	var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
-	for (var i = 0; i < 20; i++)
+	/**
+	 * Seconds each case is run for, at least.
+	 */
+	double min_time;
+
+	/**
+	 * Where the JSON report is written, or 'null' for the standard output.
+	 */
+	string? output_path;
+
+	const OptionEntry[] options =
+	{
+		{"min-time", 't', 0, OptionArg.DOUBLE,   ref min_time,    "Seconds each case runs for.",       "SECONDS"},
+		{"output",   'o', 0, OptionArg.FILENAME, ref output_path, "Where the JSON report is written.", "FILE"},
+		{null}
+	};
+
+	const string LAST_SOLUTION_HASH = "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08";
+
+	delegate void Operation (uint n_iterations);
+
+	/* run 'operation' in batches twice as large every time until one lasts
+	 * 'min_time', and return what an iteration took in nanoseconds */
+	double measure (Operation operation)
+	{
+		for (uint n_iterations = 1;; n_iterations *= 2)
+		{
+			var timer = new Timer ();
+			operation (n_iterations);
+			timer.stop ();
+
+			if (timer.elapsed () >= min_time || n_iterations >= uint.MAX / 2)
+			{
+				return timer.elapsed () * 1e9 / n_iterations;
+			}
+		}
+	}
+
+	/* the nonces the workers try in a second, solving one challenge after
+	 * another for 'min_time' whatever their prefix */
+	double measure_nonces_per_second (ChallengeType challenge_type, ChallengeParameters parameters)
+	{
+		/* the arenas are sized and mapped ahead, as they are when mining */
+		prepare_challenge (LAST_SOLUTION_HASH, challenge_type, parameters);
+
+		var cancellable = new Cancellable ();
+		var canceller   = new Thread<void> ("canceller", () => {
+			Thread.usleep ((ulong) (min_time * TimeSpan.SECOND));
+			cancellable.cancel ();
+		});
+
+		Telemetry before;
+		get_telemetry (out before);
+
+		var timer = new Timer ();
+		for (var i = 0; !cancellable.is_cancelled (); i++)
+		{
+			try
+			{
+				solve_challenge (i, challenge_type, LAST_SOLUTION_HASH, "%04x".printf (i & 0xffff), parameters, NonceStrategy.SCRAMBLE, cancellable);
+			}
+			catch (IOError.CANCELLED err)
+			{
+			}
+			catch (Error err)
+			{
+				critical ("%s (%s, %d)", err.message, err.domain.to_string (), err.code);
+				break;
+			}
+		}
+		timer.stop ();
+
+		canceller.join ();
+
+		Telemetry after;
+		get_telemetry (out after);
+
+		return (after.n_nonces - before.n_nonces) / timer.elapsed ();
+	}
+
+	void add_challenge (Json.Builder builder, ChallengeType challenge_type, ChallengeParameters parameters)
+	{
+		builder.set_member_name ("challenge");
+		builder.add_string_value (((EnumClass) typeof (ChallengeType).class_ref ()).get_value (challenge_type).value_nick);
+
+		builder.set_member_name ("parameters");
+		builder.begin_object ();
+		switch (challenge_type)
+		{
+			case ChallengeType.SORTED_LIST:
+			case ChallengeType.REVERSE_SORTED_LIST:
+				builder.set_member_name ("nb_elements");
+				builder.add_int_value (parameters.nb_elements);
+				break;
+			case ChallengeType.SHORTEST_PATH:
+				builder.set_member_name ("grid_size");
+				builder.add_int_value (parameters.grid_size);
+				builder.set_member_name ("nb_blockers");
+				builder.add_int_value (parameters.nb_blockers);
+				break;
+		}
+		builder.end_object ();
+	}
+
+	void add_microbenchmark (Json.Builder builder, string name, string? parameter_name, int parameter, string unit, double ns_per_op)
+	{
+		stderr.printf ("%s%s: %.1fns per %s\n", name, parameter_name == null ? "" : " (%s = %d)".printf (parameter_name, parameter), ns_per_op, unit);
+
+		builder.begin_object ();
+		builder.set_member_name ("name");
+		builder.add_string_value (name);
+		builder.set_member_name ("parameters");
+		builder.begin_object ();
+		if (parameter_name != null)
+		{
+			builder.set_member_name (parameter_name);
+			builder.add_int_value (parameter);
+		}
+		builder.end_object ();
+		builder.set_member_name ("unit");
+		builder.add_string_value (unit);
+		builder.set_member_name ("ns_per_op");
+		builder.add_double_value (ns_per_op);
+		builder.end_object ();
+	}
+
+	void run_microbenchmarks (Json.Builder builder)
+	{
+		builder.set_member_name ("microbenchmarks");
+		builder.begin_array ();
+
+		/* a whole batch of nonces is hashed at once by the workers */
+		var midstate = SHA256Midstate (LAST_SOLUTION_HASH);
+		var nonces   = new string[SHA256.get_seed_batch_lanes ()];
+		var seeds    = new uint64[SHA256.get_seed_batch_lanes ()];
+		for (var i = 0; i < nonces.length; i++)
+		{
+			nonces[i] = "%020d".printf (i);
+		}
+		add_microbenchmark (builder, "seed_sha256", null, 0, "nonce", measure ((n_iterations) => {
+			for (var i = 0; i < n_iterations; i++)
+			{
+				midstate.seed_batch (nonces, seeds);
+			}
+		}) / nonces.length);
+
+		var mt64 = new MT64 ();
+		add_microbenchmark (builder, "mt64_set_seed", null, 0, "seed", measure ((n_iterations) => {
+			for (var i = 0; i < n_iterations; i++)
+			{
+				mt64.set_seed (i);
+			}
+		}));
+
+		mt64.set_seed (0);
+		add_microbenchmark (builder, "mt64_next_uint64", null, 0, "number", measure ((n_iterations) => {
+			for (var i = 0; i < n_iterations; i++)
+			{
+				mt64.next_uint64 ();
+			}
+		}));
+
+		/* the generators of a batch advance in lockstep, so this is per lane */
+		var mt64xn        = MT64xN ();
+		var mt64xn_seeds  = new uint64[MT64xN.LANES];
+		var mt64xn_output = new uint64[MT64xN.LANES * 100];
+		mt64xn.set_seeds (mt64xn_seeds);
+		add_microbenchmark (builder, "mt64xn_fill_uint64", null, 0, "number", measure ((n_iterations) => {
+			for (var i = 0; i < n_iterations; i++)
+			{
+				mt64xn.fill_uint64 (mt64xn_output, 100);
+			}
+		}) / 100);
+
+		foreach (var nb_elements in new int[] {20, 100, 1000, 10000})
+		{
+			var unsorted = new uint64[nb_elements];
+			var numbers  = new uint64[nb_elements];
+			var sort     = Sort (nb_elements, false);
+			var scratch  = new uint64[sort.scratch_length];
+			mt64.fill_uint64 (unsorted);
+
+			/* the list is shuffled again before every sort, which is counted */
+			add_microbenchmark (builder, "sort", "nb_elements", nb_elements, "list", measure ((n_iterations) => {
+				for (var i = 0; i < n_iterations; i++)
+				{
+					Memory.copy (numbers, unsorted, nb_elements * sizeof (uint64));
+					sort.sort_uint64 (numbers, scratch);
+				}
+			}));
+
+			var digits = new char[nb_elements * FORMAT_UINT64_MAX_LENGTH + 1];
+			add_microbenchmark (builder, "format", "nb_elements", nb_elements, "list", measure ((n_iterations) => {
+				for (var i = 0; i < n_iterations; i++)
+				{
+					format_uint64_array (numbers, digits);
+				}
+			}));
+
+			var digits_length = format_uint64_array (numbers, digits);
+			var digest        = new uint8[SHA256Context.DIGEST_LENGTH];
+			add_microbenchmark (builder, "checksum", "nb_elements", nb_elements, "list", measure ((n_iterations) => {
+				for (var i = 0; i < n_iterations; i++)
+				{
+					var checksum = SHA256Context ();
+					checksum.init ();
+					checksum.update (((uint8[]) digits)[0:(int) digits_length]);
+					checksum.final (digest);
+				}
+			}));
+		}
+
+		foreach (var grid_size in new int[] {25, 100, 300, 1000})
+		{
+			/* as crowded as the grids the authority sends */
+			var nb_blockers = grid_size * grid_size / 5;
+			var arena       = Arena ();
+			var grid        = Grid ();
+
+			if (!arena.init (Grid.get_arena_size (grid_size)))
+			{
+				critical ("Could not allocate a grid of size %d.", grid_size);
+				continue;
+			}
+
+			grid.init (grid_size, arena);
+
+			add_microbenchmark (builder, "grid_generation", "grid_size", grid_size, "grid", measure ((n_iterations) => {
+				for (var i = 0; i < n_iterations; i++)
+				{
+					mt64.set_seed (i);
+					grid.generate (mt64, nb_blockers);
+				}
+			}));
+
+			add_microbenchmark (builder, "grid_generation_and_search", "grid_size", grid_size, "grid", measure ((n_iterations) => {
+				for (var i = 0; i < n_iterations; i++)
+				{
+					mt64.set_seed (i);
+					grid.generate (mt64, nb_blockers);
+					grid.solve ();
+				}
+			}));
+		}
+
+		builder.end_array ();
+	}
+
+	void add_nonces_per_second (Json.Builder builder, ChallengeType challenge_type, ChallengeParameters parameters)
+	{
+		var nonces_per_second = measure_nonces_per_second (challenge_type, parameters);
+
+		stderr.printf ("%s with %u workers: %.0f nonces/s\n", challenge_type.to_string (), get_n_workers (), nonces_per_second);
+
+		builder.begin_object ();
+		add_challenge (builder, challenge_type, parameters);
+		builder.set_member_name ("placement");
+		builder.add_string_value (((EnumClass) typeof (Placement).class_ref ()).get_value (get_placement ()).value_nick);
+		builder.set_member_name ("n_workers");
+		builder.add_int_value (get_n_workers ());
+		builder.set_member_name ("nonces_per_second");
+		builder.add_double_value (nonces_per_second);
+		builder.end_object ();
+	}
+
+	void run_end_to_end (Json.Builder builder)
+	{
+		builder.set_member_name ("end_to_end");
+		builder.begin_array ();
+
+		foreach (var challenge_type in new ChallengeType[] {ChallengeType.SORTED_LIST, ChallengeType.REVERSE_SORTED_LIST})
+		{
+			foreach (var nb_elements in new int[] {20, 100, 1000, 10000})
+			{
+				add_nonces_per_second (builder, challenge_type, ChallengeParameters () {nb_elements = nb_elements});
+			}
+		}
+
+		foreach (var grid_size in new int[] {25, 50, 100, 300, 1000})
+		{
+			foreach (var blockers_per_mille in new int[] {100, 200, 300})
+			{
+				add_nonces_per_second (builder, ChallengeType.SHORTEST_PATH,
+				                       ChallengeParameters () {grid_size = grid_size, nb_blockers = grid_size * grid_size * blockers_per_mille / 1000});
+			}
+		}
+
+		builder.end_array ();
+	}
+
+	/* a list and a grid of the sizes the authority sends most */
+	void add_typical_challenges (Json.Builder builder)
+	{
+		add_nonces_per_second (builder, ChallengeType.SORTED_LIST, ChallengeParameters () {nb_elements = 100});
+		add_nonces_per_second (builder, ChallengeType.SHORTEST_PATH, ChallengeParameters () {grid_size = 100, nb_blockers = 2000});
+	}
+
+	void run_thread_scaling (Json.Builder builder)
+	{
+		var n_workers = get_n_workers ();
+
+		builder.set_member_name ("thread_scaling");
+		builder.begin_array ();
+
+		for (uint max_workers = 1; max_workers < 2 * n_workers; max_workers *= 2)
+		{
+			set_max_workers (uint.min (max_workers, n_workers));
+			add_typical_challenges (builder);
+		}
+
+		set_max_workers (0);
+
+		builder.end_array ();
+	}
+
+	void run_placements (Json.Builder builder)
+	{
+		var placement_class = (EnumClass) typeof (Placement).class_ref ();
+
+		builder.set_member_name ("placements");
+		builder.begin_array ();
+
+		foreach (unowned EnumValue placement in placement_class.values)
+		{
+			set_placement ((Placement) placement.value);
+			add_typical_challenges (builder);
+		}
+
+		set_placement (Placement.ALL_THREADS);
+
+		builder.end_array ();
+	}
+
+	int main (string[] args)
 	{
-		CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, i.to_string ("%04x"), CSCoin.ChallengeParameters () {nb_elements = 20});
+		min_time    = 0.5;
+		output_path = null;
+
+		try
+		{
+			var parser = new OptionContext ();
+			parser.add_main_entries (options, null);
+			parser.parse (ref args);
+		}
+		catch (OptionError err)
+		{
+			stderr.printf ("%s\n", err.message);
+			return 1;
+		}
+
+		var builder = new Json.Builder ();
+
+		builder.begin_object ();
+		builder.set_member_name ("sha256_backend");
+		builder.add_string_value (SHA256.get_backend_name ());
+		builder.set_member_name ("seed_batch_backend");
+		builder.add_string_value (SHA256.get_seed_batch_backend_name ());
+		builder.set_member_name ("seed_batch_lanes");
+		builder.add_int_value (SHA256.get_seed_batch_lanes ());
+		builder.set_member_name ("mt64_backend");
+		builder.add_string_value (MT64.get_backend_name ());
+		builder.set_member_name ("n_workers");
+		builder.add_int_value (get_n_workers ());
+		builder.set_member_name ("min_time");
+		builder.add_double_value (min_time);
+
+		run_microbenchmarks (builder);
+		run_end_to_end (builder);
+		run_thread_scaling (builder);
+		run_placements (builder);
+
+		builder.end_object ();
+
+		var generator = new Json.Generator ();
+		generator.pretty = true;
+		generator.root   = builder.get_root ();
+
+		if (output_path == null)
+		{
+			print ("%s\n", generator.to_data (null));
+		}
+		else
+		{
+			try
+			{
+				generator.to_file (output_path);
+			}
+			catch (Error err)
+			{
+				stderr.printf ("Could not write the report to '%s': %s\n", output_path, err.message);
+				return 1;
+			}
+		}
+
+		return 0;
 	}
 }
@@ -0,0 +1,169 @@
+#include "cscoin-arena.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/* blocks this large start on a huge page and are made of whole ones */
+static inline gsize
+get_block_size (gsize size)
+{
+    size = CSCOIN_ARENA_ALIGN (MAX (size, 1));
+
+    if (size >= CSCOIN_ARENA_HUGE_PAGE_SIZE)
+    {
+        size = (size + CSCOIN_ARENA_HUGE_PAGE_SIZE - 1) & ~((gsize) CSCOIN_ARENA_HUGE_PAGE_SIZE - 1);
+    }
+
+    return size;
+}
+
+static guint8 *
+allocate_block (gsize size)
+{
+    gpointer data;
+    gsize alignment = size >= CSCOIN_ARENA_HUGE_PAGE_SIZE ? CSCOIN_ARENA_HUGE_PAGE_SIZE : CSCOIN_ARENA_ALIGNMENT;
+
+    if (posix_memalign (&data, alignment, size) != 0)
+    {
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    /* large grids and lists are walked all over, so fewer pages means fewer
+     * TLB misses; the kernel is free to ignore the advice */
+    if (alignment == CSCOIN_ARENA_HUGE_PAGE_SIZE)
+    {
+        madvise (data, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return data;
+}
+
+/* twice the current block, or what is left under the limit, or 0 if that
+ * cannot hold 'size' bytes */
+static gsize
+get_next_block_size (const CSCoinArena *self, gsize size)
+{
+    gsize next = get_block_size (MAX (2 * self->size, size));
+    gsize room;
+
+    if (self->limit == 0 || self->footprint + next <= self->limit)
+    {
+        return next;
+    }
+
+    room = self->limit > self->footprint ? self->limit - self->footprint : 0;
+    next = room >= CSCOIN_ARENA_HUGE_PAGE_SIZE ? room & ~((gsize) CSCOIN_ARENA_HUGE_PAGE_SIZE - 1) : room & ~((gsize) CSCOIN_ARENA_ALIGNMENT - 1);
+
+    return next >= get_block_size (size) ? next : 0;
+}
+
+/* FALSE if the block could not be allocated, in which case the arena only
+ * needs to be cleared */
+gboolean
+cscoin_arena_init (CSCoinArena *self, gsize size)
+{
+    self->size      = get_block_size (size);
+    self->data      = allocate_block (self->size);
+    self->used      = 0;
+    self->base      = 0;
+    self->retired   = NULL;
+    self->footprint = self->size;
+    self->limit     = 0;
+
+    return self->data != NULL;
+}
+
+void
+cscoin_arena_clear (CSCoinArena *self)
+{
+    g_slist_free_full (self->retired, free);
+    free (self->data);
+}
+
+void
+cscoin_arena_set_limit (CSCoinArena *self, gsize limit)
+{
+    self->limit = limit;
+}
+
+/* NULL if 'size' bytes do not fit and the arena cannot grow */
+gpointer
+cscoin_arena_alloc (CSCoinArena *self, gsize size)
+{
+    gpointer mem;
+    guint8 *data;
+    gsize next_size;
+
+    size = CSCOIN_ARENA_ALIGN (size);
+
+    if (G_UNLIKELY (self->used + size > self->size))
+    {
+        next_size = get_next_block_size (self, size);
+
+        if (next_size == 0 || (data = allocate_block (next_size)) == NULL)
+        {
+            return NULL;
+        }
+
+        self->retired    = g_slist_prepend (self->retired, self->data);
+        self->data       = data;
+        self->size       = next_size;
+        self->footprint += next_size;
+        self->used       = 0;
+        self->base       = 0;
+    }
+
+    mem         = self->data + self->used;
+    self->used += size;
+
+    return mem;
+}
+
+/* give back the tail of 'mem', which must be the last allocation */
+void
+cscoin_arena_shrink (CSCoinArena *self, gpointer mem, gsize size)
+{
+    self->used = ((guint8 *) mem - self->data) + CSCOIN_ARENA_ALIGN (size);
+}
+
+void
+cscoin_arena_seal (CSCoinArena *self)
+{
+    self->base = self->used;
+}
+
+void
+cscoin_arena_reset (CSCoinArena *self)
+{
+    self->used = self->base;
+}
+
+/* drop everything, sealed or not, but keep the current block for reuse */
+void
+cscoin_arena_rewind (CSCoinArena *self)
+{
+    g_slist_free_full (self->retired, free);
+
+    self->retired   = NULL;
+    self->footprint = self->size;
+    self->used      = 0;
+    self->base      = 0;
+}
+
+/* touch the pages of the first 'size' bytes of the block, so that the
+ * allocations that land there do not fault them in one at a time */
+void
+cscoin_arena_prefault (CSCoinArena *self, gsize size)
+{
+    volatile guint8 *data = self->data;
+    gsize offset;
+
+    size = MIN (size, self->size);
+
+    for (offset = 0; offset < size; offset += CSCOIN_ARENA_PAGE_SIZE)
+    {
+        data[offset] = 0;
+    }
+}
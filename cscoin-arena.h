@@ -0,0 +1,66 @@
+#ifndef __CSCOIN_ARENA_H__
+#define __CSCOIN_ARENA_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* every allocation starts on a cache line */
+#define CSCOIN_ARENA_ALIGNMENT 64
+
+/* the stride at which a block is touched ahead of its use */
+#define CSCOIN_ARENA_PAGE_SIZE 4096
+
+/* blocks from this size on are backed by transparent huge pages */
+#define CSCOIN_ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#define CSCOIN_ARENA_ALIGN(size) (((size) + CSCOIN_ARENA_ALIGNMENT - 1) & ~((gsize) CSCOIN_ARENA_ALIGNMENT - 1))
+
+typedef struct _CSCoinArena CSCoinArena;
+
+/*
+ * A bump allocator over a single block. What is allocated before
+ * 'cscoin_arena_seal' lasts until the arena is cleared, and what comes after
+ * is dropped at once by 'cscoin_arena_reset'.
+ *
+ * An allocation that does not fit moves the arena to a block twice as
+ * large. The outgrown blocks stay alive until the arena is cleared or
+ * rewound, since sealed allocations may still point in them, and they all
+ * count in 'footprint'.
+ *
+ * Blocks are not grown past 'limit' bytes in all, or past what the system
+ * can give, in which case the allocation fails and the arena is left as it
+ * was. A 'limit' of 0 stands for none.
+ */
+struct _CSCoinArena
+{
+    guint8 *data;
+    gsize   size;
+    gsize   used;
+    gsize   base;
+    GSList *retired;
+    gsize   footprint;
+    gsize   limit;
+};
+
+gboolean cscoin_arena_init      (CSCoinArena *self,
+                                 gsize        size);
+void     cscoin_arena_clear     (CSCoinArena *self);
+void     cscoin_arena_set_limit (CSCoinArena *self,
+                                 gsize        limit);
+gpointer cscoin_arena_alloc     (CSCoinArena *self,
+                                 gsize        size);
+void     cscoin_arena_shrink    (CSCoinArena *self,
+                                 gpointer     mem,
+                                 gsize        size);
+void     cscoin_arena_seal      (CSCoinArena *self);
+void     cscoin_arena_reset     (CSCoinArena *self);
+void     cscoin_arena_rewind    (CSCoinArena *self);
+void     cscoin_arena_prefault  (CSCoinArena *self,
+                                 gsize        size);
+
+#define cscoin_arena_new(self, struct_type, n_structs) ((struct_type *) cscoin_arena_alloc ((self), sizeof (struct_type) * (n_structs)))
+
+G_END_DECLS
+
+#endif /* __CSCOIN_ARENA_H__ */
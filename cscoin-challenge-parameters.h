@@ -4,6 +4,8 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#include "cscoin-grid-movement.h"
+
 G_BEGIN_DECLS
 
 typedef union _CSCoinChallengeParameters CSCoinChallengeParameters;
@@ -18,10 +20,15 @@ union _CSCoinChallengeParameters
     {
         gint nb_elements;
     } reverse_sorted_list;
+    /* zeroed costs stand for the classic grid: unit moves and blank tiles */
     struct
     {
-        gint grid_size;
-        gint nb_blockers;
+        gint               grid_size;
+        gint               nb_blockers;
+        CSCoinGridMovement movement;
+        gint               move_cost;
+        gint               diagonal_cost;
+        gint               max_tile_cost;
     } shortest_path;
 };
 
@@ -8,11 +8,18 @@ public class CSCoin.Challenge : GLib.Object
 	public ChallengeParameters parameters         { get; construct; }
 	public Cancellable         cancellable        { get; construct; }
 
-	public Challenge.from_json_object (Json.Object node, Cancellable cancellable)
+	public Challenge.from_json_object (Json.Object node, Cancellable cancellable) throws IOError
 	{
 		var parameters = node.get_member ("parameters").get_object ();
 		var challenge_parameters = ChallengeParameters ();
-		var challenge_type = ((EnumClass) typeof (ChallengeType).class_ref ()).get_value_by_nick (node.get_string_member ("challenge_name")).value;
+
+		unowned EnumValue? challenge_type_value = ((EnumClass) typeof (ChallengeType).class_ref ()).get_value_by_nick (node.get_string_member ("challenge_name"));
+		if (challenge_type_value == null)
+		{
+			throw new IOError.NOT_SUPPORTED ("Unknown challenge '%s'.", node.get_string_member ("challenge_name"));
+		}
+
+		var challenge_type = (ChallengeType) challenge_type_value.value;
 
 		switch (challenge_type)
 		{
@@ -23,6 +30,28 @@ public class CSCoin.Challenge : GLib.Object
 			case ChallengeType.SHORTEST_PATH:
 				challenge_parameters.grid_size   = (int) parameters.get_int_member ("grid_size");
 				challenge_parameters.nb_blockers = (int) parameters.get_int_member ("nb_blockers");
+				/* the variants leave these out for the classic grid */
+				if (parameters.has_member ("movement"))
+				{
+					unowned EnumValue? movement_value = ((EnumClass) typeof (GridMovement).class_ref ()).get_value_by_nick (parameters.get_string_member ("movement"));
+					if (movement_value == null)
+					{
+						throw new IOError.NOT_SUPPORTED ("Unknown movement '%s'.", parameters.get_string_member ("movement"));
+					}
+					challenge_parameters.movement = (GridMovement) movement_value.value;
+				}
+				if (parameters.has_member ("move_cost"))
+				{
+					challenge_parameters.move_cost = (int) parameters.get_int_member ("move_cost");
+				}
+				if (parameters.has_member ("diagonal_cost"))
+				{
+					challenge_parameters.diagonal_cost = (int) parameters.get_int_member ("diagonal_cost");
+				}
+				if (parameters.has_member ("max_tile_cost"))
+				{
+					challenge_parameters.max_tile_cost = (int) parameters.get_int_member ("max_tile_cost");
+				}
 				break;
 		}
 
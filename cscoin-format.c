@@ -0,0 +1,96 @@
+#include "cscoin-format.h"
+
+#include <string.h>
+
+static const gchar
+DIGIT_PAIRS[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* the first entry is zero so that '0' counts as one digit */
+static const guint64
+POWERS_OF_10[CSCOIN_FORMAT_UINT64_MAX_LENGTH] =
+{
+    0ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+/*
+ * 1233 / 4096 approximates log10 (2), so the bit length gives the digit
+ * count up to one, which a single comparison settles.
+ */
+static inline gsize
+count_digits (guint64 value)
+{
+    guint t = ((64 - __builtin_clzll (value | 1)) * 1233) >> 12;
+
+    return t + 1 - (value < POWERS_OF_10[t]);
+}
+
+/* 'str' is not nul-terminated, and the number of digits is returned */
+gsize
+cscoin_format_uint64 (guint64 value, gchar *str)
+{
+    gsize len = count_digits (value);
+    gchar *pos = str + len;
+
+    /* two digits per division, from the least significant end */
+    while (value >= 100)
+    {
+        pos   -= 2;
+        memcpy (pos, DIGIT_PAIRS + (value % 100) * 2, 2);
+        value /= 100;
+    }
+
+    if (value >= 10)
+    {
+        memcpy (pos - 2, DIGIT_PAIRS + value * 2, 2);
+    }
+    else
+    {
+        pos[-1] = '0' + value;
+    }
+
+    return len;
+}
+
+/* the numbers are concatenated, so that they can be hashed in a single update */
+gsize
+cscoin_format_uint64_array (const guint64 *numbers, gsize n_numbers, gchar *str)
+{
+    gchar *pos = str;
+    gsize i;
+
+    for (i = 0; i < n_numbers; i++)
+    {
+        pos += cscoin_format_uint64 (numbers[i], pos);
+    }
+
+    return pos - str;
+}
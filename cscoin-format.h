@@ -0,0 +1,19 @@
+#ifndef __CSCOIN_FORMAT_H__
+#define __CSCOIN_FORMAT_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* decimal digits of G_MAXUINT64 */
+#define CSCOIN_FORMAT_UINT64_MAX_LENGTH 20
+
+gsize cscoin_format_uint64       (guint64        value,
+                                  gchar         *str);
+gsize cscoin_format_uint64_array (const guint64 *numbers,
+                                  gsize          n_numbers,
+                                  gchar         *str);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_FORMAT_H__ */
@@ -0,0 +1,24 @@
+#include "cscoin-grid-movement.h"
+
+static const GEnumValue
+GRID_MOVEMENT_ENUM_VALUES[] =
+{
+    {0, "CSCOIN_GRID_MOVEMENT_CARDINAL", "cardinal"},
+    {1, "CSCOIN_GRID_MOVEMENT_EIGHT_WAY", "eight-way"},
+    NULL
+};
+
+static GType
+cscoin_grid_movement = 0;
+
+GType
+cscoin_grid_movement_get_type ()
+{
+    if (g_once_init_enter (&cscoin_grid_movement))
+    {
+        GType cscoin_grid_movement_value = g_enum_register_static ("CSCoinGridMovement", GRID_MOVEMENT_ENUM_VALUES);
+        g_once_init_leave (&cscoin_grid_movement, cscoin_grid_movement_value);
+    }
+
+    return cscoin_grid_movement;
+}
@@ -0,0 +1,21 @@
+#ifndef __CSCOIN_GRID_MOVEMENT_H__
+#define __CSCOIN_GRID_MOVEMENT_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef enum _CSCoinGridMovement CSCoinGridMovement;
+
+enum _CSCoinGridMovement
+{
+    CSCOIN_GRID_MOVEMENT_CARDINAL,
+    CSCOIN_GRID_MOVEMENT_EIGHT_WAY
+};
+
+#define CSCOIN_TYPE_GRID_MOVEMENT cscoin_grid_movement_get_type ()
+GType cscoin_grid_movement_get_type ();
+
+G_END_DECLS
+
+#endif /* __CSCOIN_GRID_MOVEMENT_H__ */
@@ -0,0 +1,659 @@
+#include "cscoin-grid.h"
+#include "cscoin-format.h"
+
+#include <string.h>
+
+#ifdef __SIZEOF_INT128__
+#define CSCOIN_GRID_HAVE_INT128
+#endif
+
+#define CSCOIN_GRID_N_DIRECTIONS 4
+
+/* coordinates are drawn up to a whole MT64 state at a time */
+#define CSCOIN_GRID_DRAW_BLOCK 312
+
+/* the digits of a coordinate, copied whole, and their count in the last byte */
+#define CSCOIN_GRID_COORDINATE_SLOT 16
+
+static inline gsize
+get_word (const CSCoinGrid *self, gint y, gint x)
+{
+    return (gsize) y * self->words_per_row + x / 64;
+}
+
+static inline gboolean
+test_cell (const CSCoinGrid *self, const guint64 *bits, guint32 cell)
+{
+    gint y = cell / self->size;
+    gint x = cell % self->size;
+
+    return (bits[get_word (self, y, x)] >> (x % 64)) & 1;
+}
+
+/* the number of layers a side can reach, which is one per blank tile at most */
+static inline gsize
+get_max_layers (gint size)
+{
+    return (gsize) (size - 2) * (size - 2);
+}
+
+/* the path digits, which two coordinates per cell never exceed */
+static inline gsize
+get_max_path_digits (gint size)
+{
+    gchar digits[CSCOIN_FORMAT_UINT64_MAX_LENGTH];
+
+    return get_max_layers (size) * 2 * cscoin_format_uint64 (size - 1, digits) + CSCOIN_GRID_COORDINATE_SLOT;
+}
+
+/*
+ * The grid and its searches, plus room for 'size / 4' frontiers on each
+ * side that span half of the rows. On random grids of 300 and 1000 tiles a
+ * side with a fifth of them blocked, that held about 70% of the searches
+ * and the largest took under 75% of the room for 'size' such frontiers, so
+ * the rest move the arena to a larger block once rather than every worker
+ * reserving for them.
+ */
+gsize
+cscoin_grid_get_arena_size (gint size)
+{
+    gsize words_per_row = (size + 63) / 64;
+    gsize n_words = (gsize) size * words_per_row;
+    gsize half = size / 2;
+    gsize search_size;
+
+    search_size = CSCOIN_ARENA_ALIGN (n_words * sizeof (guint64)) +
+                  CSCOIN_ARENA_ALIGN (get_max_layers (size) * sizeof (CSCoinGridLayer)) +
+                  half * (size / 4) * words_per_row * sizeof (guint64) + size * CSCOIN_ARENA_ALIGNMENT;
+
+    return CSCOIN_ARENA_ALIGN (n_words * sizeof (guint64)) +
+           2 * CSCOIN_ARENA_ALIGN (words_per_row * sizeof (guint64)) +
+           CSCOIN_ARENA_ALIGN (CSCOIN_GRID_DRAW_BLOCK * sizeof (guint64)) +
+           CSCOIN_ARENA_ALIGN ((gsize) size * CSCOIN_GRID_COORDINATE_SLOT) +
+           CSCOIN_ARENA_ALIGN (get_max_path_digits (size)) +
+           2 * search_size;
+}
+
+static void
+search_init (CSCoinGridSearch *search, CSCoinArena *arena, gsize n_words, gint size)
+{
+    search->visited  = cscoin_arena_new (arena, guint64, n_words);
+    search->layers   = cscoin_arena_new (arena, CSCoinGridLayer, get_max_layers (size));
+    search->n_layers = 0;
+}
+
+/*
+ * The grid takes its part of 'arena' for good, so that whatever is
+ * allocated after it can be reset on every search.
+ */
+void
+cscoin_grid_init (CSCoinGrid *self, gint size, CSCoinArena *arena)
+{
+    gsize n_words;
+    gint i;
+
+    self->arena         = arena;
+    self->size          = size;
+    self->words_per_row = (size + 63) / 64;
+    self->start         = 0;
+    self->end           = 0;
+
+    n_words = (gsize) size * self->words_per_row;
+
+    self->blockers   = cscoin_arena_new (arena, guint64, n_words);
+    self->empty_row  = cscoin_arena_new (arena, guint64, self->words_per_row);
+    self->spread_row = cscoin_arena_new (arena, guint64, self->words_per_row);
+
+    self->draws      = cscoin_arena_new (arena, guint64, CSCOIN_GRID_DRAW_BLOCK);
+    self->n_draws    = 0;
+    self->draw_index = 0;
+
+    memset (self->empty_row, 0, self->words_per_row * sizeof (guint64));
+
+#ifdef CSCOIN_GRID_HAVE_INT128
+    {
+        unsigned __int128 reciprocal = ~(unsigned __int128) 0 / size + 1;
+
+        self->size_reciprocal[0] = (guint64) reciprocal;
+        self->size_reciprocal[1] = (guint64) (reciprocal >> 64);
+    }
+#endif
+
+    search_init (&self->from_start, arena, n_words, size);
+    search_init (&self->from_end, arena, n_words, size);
+
+    self->coordinates = cscoin_arena_new (arena, gchar, (gsize) size * CSCOIN_GRID_COORDINATE_SLOT);
+
+    for (i = 0; i < size; i++)
+    {
+        gchar *slot = self->coordinates + (gsize) i * CSCOIN_GRID_COORDINATE_SLOT;
+
+        slot[CSCOIN_GRID_COORDINATE_SLOT - 1] = cscoin_format_uint64 (i, slot);
+    }
+
+    self->path_digits        = cscoin_arena_new (arena, gchar, get_max_path_digits (size));
+    self->path_digits_length = 0;
+
+    memset (&self->statistics, 0, sizeof (self->statistics));
+
+    cscoin_arena_seal (arena);
+}
+
+/*
+ * Lemire's direct remainder: with 'size_reciprocal' holding ceil (2^128 /
+ * size), 'n % size' is the top of '(size_reciprocal * n mod 2^128) * size',
+ * exactly, for every 64-bit 'n'.
+ */
+static inline guint64
+reduce (const CSCoinGrid *self, guint64 n)
+{
+#ifdef CSCOIN_GRID_HAVE_INT128
+    unsigned __int128 reciprocal = ((unsigned __int128) self->size_reciprocal[1] << 64) | self->size_reciprocal[0];
+    unsigned __int128 fraction = reciprocal * n;
+    unsigned __int128 low = ((unsigned __int128) (guint64) fraction * (guint32) self->size) >> 64;
+    unsigned __int128 high = (fraction >> 64) * (guint32) self->size;
+
+    return (guint64) ((low + high) >> 64);
+#else
+    return n % self->size;
+#endif
+}
+
+/*
+ * Outputs are drawn a block at a time, but never more than the 'n_tiles'
+ * left to place need, and reduced to coordinates as they are consumed.
+ */
+static inline void
+draw_tile (CSCoinGrid *self, CSCoinMT64 *mt64, gsize n_tiles, gint *y, gint *x)
+{
+    if (self->draw_index == self->n_draws)
+    {
+        self->n_draws    = MIN (2 * n_tiles, CSCOIN_GRID_DRAW_BLOCK);
+        self->draw_index = 0;
+        cscoin_mt64_fill_uint64 (mt64, self->draws, self->n_draws);
+    }
+
+    *y = reduce (self, self->draws[self->draw_index]);
+    *x = reduce (self, self->draws[self->draw_index + 1]);
+    self->draw_index += 2;
+}
+
+static guint32
+place_tile (CSCoinGrid *self, CSCoinMT64 *mt64, gsize n_tiles)
+{
+    guint64 *word;
+    gint x, y;
+
+    for (;;)
+    {
+        draw_tile (self, mt64, n_tiles, &y, &x);
+
+        word = &self->blockers[get_word (self, y, x)];
+
+        if (!((*word >> (x % 64)) & 1))
+        {
+            *word |= G_GUINT64_CONSTANT (1) << (x % 64);
+            return y * self->size + x;
+        }
+    }
+}
+
+static inline void
+unblock_cell (CSCoinGrid *self, guint32 cell)
+{
+    gint y = cell / self->size;
+    gint x = cell % self->size;
+
+    self->blockers[get_word (self, y, x)] &= ~(G_GUINT64_CONSTANT (1) << (x % 64));
+}
+
+/*
+ * Lay out the borders, then the start, the end and the blockers in the
+ * order they are drawn from 'mt64'. A blocker that lands on a tile that is
+ * not blank is dropped.
+ *
+ * The start and the end stay blocked until every blocker is laid, so that
+ * dropping one is the same as setting a bit that is already set.
+ */
+void
+cscoin_grid_generate (CSCoinGrid *self, CSCoinMT64 *mt64, gint nb_blockers)
+{
+    gint size = self->size;
+    gint words_per_row = self->words_per_row;
+    gsize n_blockers = MAX (nb_blockers, 0);
+    guint64 *row;
+    gint x, y;
+    gsize i;
+
+    /* the bits past the last column are blocked as well, so the search never
+     * has to mask them out */
+    memset (self->blockers, 0xff, (gsize) words_per_row * sizeof (guint64));
+    memset (self->blockers + (gsize) (size - 1) * words_per_row, 0xff, (gsize) words_per_row * sizeof (guint64));
+
+    for (i = 1; i < (gsize) size - 1; i++)
+    {
+        row = self->blockers + i * words_per_row;
+
+        memset (row, 0, (gsize) words_per_row * sizeof (guint64));
+        row[0]               |= 1;
+        row[(size - 1) / 64] |= ~G_GUINT64_CONSTANT (0) << ((size - 1) % 64);
+    }
+
+    self->n_draws    = 0;
+    self->draw_index = 0;
+
+    self->start = place_tile (self, mt64, n_blockers + 2);
+    self->end   = place_tile (self, mt64, n_blockers + 1);
+
+    for (i = 0; i < n_blockers; i++)
+    {
+        draw_tile (self, mt64, n_blockers - i, &y, &x);
+        self->blockers[get_word (self, y, x)] |= G_GUINT64_CONSTANT (1) << (x % 64);
+    }
+
+    unblock_cell (self, self->start);
+    unblock_cell (self, self->end);
+}
+
+/*
+ * Among the shortest paths, the one kept steps to the first neighbour of
+ * this list that is one move closer to the end: up, down, left, then right.
+ *
+ * That order is an assumption: no pair of a nonce and a path from the
+ * authority confirms it. The costs once hinted at for libastar would rather
+ * go up, left, right then down, and its own A* keeps yet other paths, so
+ * this list and the moves below are what to change once a pair is known.
+ */
+static inline void
+get_neighbour_offsets (const CSCoinGrid *self, gssize offsets[CSCOIN_GRID_N_DIRECTIONS])
+{
+    offsets[0] = -self->size;
+    offsets[1] = self->size;
+    offsets[2] = -1;
+    offsets[3] = 1;
+}
+
+/* the same neighbours, as moves along the rows and the columns */
+static const gint NEIGHBOUR_ROWS[CSCOIN_GRID_N_DIRECTIONS]    = {-1, 1, 0, 0};
+static const gint NEIGHBOUR_COLUMNS[CSCOIN_GRID_N_DIRECTIONS] = {0, 0, -1, 1};
+
+static gboolean
+is_enclosed (const CSCoinGrid *self, guint32 cell, const gssize offsets[CSCOIN_GRID_N_DIRECTIONS])
+{
+    gint k;
+
+    for (k = 0; k < CSCOIN_GRID_N_DIRECTIONS; k++)
+    {
+        if (!test_cell (self, self->blockers, cell + offsets[k]))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* rows outside of the layer read as the empty row */
+static inline const guint64 *
+get_frontier_row (const CSCoinGrid *self, const CSCoinGridSearch *search, const CSCoinGridLayer *layer, gint y)
+{
+    if (y < layer->row_min || y > layer->row_max)
+    {
+        return self->empty_row;
+    }
+
+    return layer->rows + (gsize) (y - layer->row_min) * self->words_per_row;
+}
+
+static inline gboolean
+test_frontier (const CSCoinGrid *self, const CSCoinGridSearch *search, const CSCoinGridLayer *layer, gint y, gint x)
+{
+    const guint64 *row = get_frontier_row (self, search, layer, y);
+
+    return (row[x / 64] >> (x % 64)) & 1;
+}
+
+/*
+ * Spread row 'y' of a frontier to its four neighbours into 'out': shifts
+ * move the columns, and the rows above and below are merged whole.
+ */
+static inline void
+spread_row (const CSCoinGrid *self, const CSCoinGridSearch *search, const CSCoinGridLayer *layer, gint y, guint64 *out)
+{
+    gint words_per_row = self->words_per_row;
+    const guint64 *above = get_frontier_row (self, search, layer, y - 1);
+    const guint64 *row   = get_frontier_row (self, search, layer, y);
+    const guint64 *below = get_frontier_row (self, search, layer, y + 1);
+    guint64 current, following, carry = 0;
+    gint w;
+
+    for (w = 0; w < words_per_row; w++)
+    {
+        /* the columns shift across words: the top bit of a word moves right
+         * into the next one, and its bottom bit left into the previous one */
+        current   = row[w];
+        following = w + 1 < words_per_row ? row[w + 1] : 0;
+        out[w]    = (current << 1) | carry | (current >> 1) | (following << 63) | above[w] | below[w];
+        carry     = current >> 63;
+    }
+}
+
+/*
+ * Start a side of the search with the lone 'origin' as its first frontier.
+ *
+ * Returns FALSE if that frontier does not fit in the arena.
+ */
+static gboolean
+search_reset (CSCoinGrid *self, CSCoinGridSearch *search, guint32 origin)
+{
+    gint y = origin / self->size;
+    gint x = origin % self->size;
+    CSCoinGridLayer *layer = &search->layers[0];
+
+    memset (search->visited, 0, (gsize) self->size * self->words_per_row * sizeof (guint64));
+    search->visited[get_word (self, y, x)] |= G_GUINT64_CONSTANT (1) << (x % 64);
+
+    layer->row_min = y;
+    layer->row_max = y;
+    layer->rows    = cscoin_arena_new (self->arena, guint64, self->words_per_row);
+
+    if (layer->rows == NULL)
+    {
+        return FALSE;
+    }
+
+    memset (layer->rows, 0, self->words_per_row * sizeof (guint64));
+    layer->rows[x / 64] = G_GUINT64_CONSTANT (1) << (x % 64);
+
+    search->n_layers = 1;
+
+    return TRUE;
+}
+
+/*
+ * Spread the last frontier of 'search' and drop the blocked and already
+ * visited cells. The new frontier is trimmed to the rows it actually
+ * reaches, and 'met' tells whether it touches a cell that 'other' visited.
+ *
+ * Returns FALSE if the frontier is empty, or if it does not fit in the
+ * arena, as 'out_of_memory' tells; either way the search is over.
+ */
+static gboolean
+expand_frontier (CSCoinGrid *self, CSCoinGridSearch *search, const CSCoinGridSearch *other, gboolean *met, gboolean *out_of_memory)
+{
+    gint words_per_row = self->words_per_row;
+    const CSCoinGridLayer *last;
+    CSCoinGridLayer *next;
+    const guint64 *open, *other_visited;
+    guint64 *rows, *out, *visited;
+    guint64 bits, reached, touched = 0;
+    gint row_min, row_max, y, w;
+
+    last    = &search->layers[search->n_layers - 1];
+    next    = &search->layers[search->n_layers];
+    row_min = MAX (last->row_min - 1, 1);
+    row_max = MIN (last->row_max + 1, self->size - 2);
+
+    next->row_min = G_MAXINT;
+    next->row_max = -1;
+
+    rows = cscoin_arena_new (self->arena, guint64, (gsize) (row_max - row_min + 1) * words_per_row);
+
+    if (rows == NULL)
+    {
+        *out_of_memory = TRUE;
+        return FALSE;
+    }
+
+    for (y = row_min, out = rows; y <= row_max; y++, out += words_per_row)
+    {
+        open          = self->blockers + (gsize) y * words_per_row;
+        visited       = search->visited + (gsize) y * words_per_row;
+        other_visited = other->visited + (gsize) y * words_per_row;
+        reached       = 0;
+
+        spread_row (self, search, last, y, out);
+
+        for (w = 0; w < words_per_row; w++)
+        {
+            bits        = out[w] & ~open[w] & ~visited[w];
+            out[w]      = bits;
+            visited[w] |= bits;
+            reached    |= bits;
+            touched    |= bits & other_visited[w];
+        }
+
+        if (reached != 0)
+        {
+            next->row_min = MIN (next->row_min, y);
+            next->row_max = y;
+        }
+    }
+
+    *met = touched != 0;
+
+    if (next->row_max < 0)
+    {
+        return FALSE;
+    }
+
+    /* the rows before the first reached one are skipped, and the ones after
+     * the last reached one go back to the arena */
+    next->rows = rows + (gsize) (next->row_min - row_min) * words_per_row;
+    cscoin_arena_shrink (self->arena, rows, (gsize) (next->row_max - row_min + 1) * words_per_row * sizeof (guint64));
+    search->n_layers++;
+
+    return TRUE;
+}
+
+static inline CSCoinGridLayer *
+get_last_layer (CSCoinGridSearch *search)
+{
+    return &search->layers[search->n_layers - 1];
+}
+
+static inline gint
+get_row_span (const CSCoinGridLayer *layer)
+{
+    return layer->row_max - layer->row_min + 1;
+}
+
+/*
+ * The frontiers meet in the last layers of both sides, since the ones
+ * before never did: keep in the last frontier from the start only the cells
+ * that the last frontier from the end holds as well.
+ */
+static void
+meet_frontiers (CSCoinGrid *self)
+{
+    gint words_per_row = self->words_per_row;
+    CSCoinGridLayer *start_layer = get_last_layer (&self->from_start);
+    const CSCoinGridLayer *end_layer = get_last_layer (&self->from_end);
+    guint64 *row;
+    const guint64 *other;
+    gint y, w;
+
+    for (y = start_layer->row_min; y <= start_layer->row_max; y++)
+    {
+        row   = start_layer->rows + (gsize) (y - start_layer->row_min) * words_per_row;
+        other = get_frontier_row (self, &self->from_end, end_layer, y);
+
+        for (w = 0; w < words_per_row; w++)
+        {
+            row[w] &= other[w];
+        }
+    }
+}
+
+/*
+ * Once the frontiers meet, narrow every frontier from the start down to the
+ * cells of the shortest paths: those that neighbour such a cell one layer
+ * further. The last layer already holds only the meeting cells.
+ */
+static void
+narrow_frontiers (CSCoinGrid *self)
+{
+    CSCoinGridSearch *search = &self->from_start;
+    gint words_per_row = self->words_per_row;
+    const CSCoinGridLayer *further;
+    CSCoinGridLayer *layer;
+    guint64 *row;
+    guint64 *spread = self->spread_row;
+    gsize i;
+    gint y, w;
+
+    for (i = search->n_layers - 1; i-- > 1;)
+    {
+        layer   = &search->layers[i];
+        further = &search->layers[i + 1];
+
+        for (y = layer->row_min; y <= layer->row_max; y++)
+        {
+            row = layer->rows + (gsize) (y - layer->row_min) * words_per_row;
+
+            spread_row (self, search, further, y, spread);
+
+            for (w = 0; w < words_per_row; w++)
+            {
+                row[w] &= spread[w];
+            }
+        }
+    }
+}
+
+/*
+ * Append the row then the column of a cell to 'pos'. Whole slots are
+ * copied, so up to a slot past the digits is written.
+ */
+static inline gchar *
+emit_cell (const CSCoinGrid *self, gchar *pos, gint y, gint x)
+{
+    const gchar *row    = self->coordinates + (gsize) y * CSCOIN_GRID_COORDINATE_SLOT;
+    const gchar *column = self->coordinates + (gsize) x * CSCOIN_GRID_COORDINATE_SLOT;
+
+    memcpy (pos, row, CSCOIN_GRID_COORDINATE_SLOT);
+    pos += row[CSCOIN_GRID_COORDINATE_SLOT - 1];
+    memcpy (pos, column, CSCOIN_GRID_COORDINATE_SLOT);
+
+    return pos + column[CSCOIN_GRID_COORDINATE_SLOT - 1];
+}
+
+/*
+ * Bit-parallel breadth-first search from both the start and the end at
+ * once, always spreading the side whose frontier spans fewer rows. The
+ * borders are blockers, so neighbours never fall off the grid.
+ *
+ * After the first step 'd' of the walk, the cell on a shortest path is found
+ * in the frontier 'd' away from the start, narrowed to the shortest paths,
+ * or in the frontier 'length - d' away from the end.
+ *
+ * On success, 'path_digits' holds the coordinates of the cells from the
+ * start to the end inclusively.
+ */
+gboolean
+cscoin_grid_solve (CSCoinGrid *self)
+{
+    CSCoinGridSearch *from_start = &self->from_start;
+    CSCoinGridSearch *from_end   = &self->from_end;
+    CSCoinGridSearch *search, *other;
+    const CSCoinGridLayer *layer;
+    gboolean met = FALSE, out_of_memory = FALSE;
+    gssize offsets[CSCOIN_GRID_N_DIRECTIONS];
+    gchar *pos;
+    gsize i, length;
+    gint k, x, y;
+
+    get_neighbour_offsets (self, offsets);
+
+    self->path_digits_length = 0;
+
+    /* a walled-in start or end is by far the most common dead grid */
+    if (is_enclosed (self, self->start, offsets) || is_enclosed (self, self->end, offsets))
+    {
+        self->statistics.n_enclosed++;
+        return FALSE;
+    }
+
+    /* the frontiers of the previous search are dropped all at once */
+    cscoin_arena_reset (self->arena);
+
+    if (!search_reset (self, from_start, self->start) || !search_reset (self, from_end, self->end))
+    {
+        self->statistics.n_oversized++;
+        return FALSE;
+    }
+
+    while (!met)
+    {
+        if (get_row_span (get_last_layer (from_start)) <= get_row_span (get_last_layer (from_end)))
+        {
+            search = from_start;
+            other  = from_end;
+        }
+        else
+        {
+            search = from_end;
+            other  = from_start;
+        }
+
+        /* the side that runs dry first is enclosed in the smaller region */
+        if (!expand_frontier (self, search, other, &met, &out_of_memory))
+        {
+            if (out_of_memory)
+            {
+                self->statistics.n_oversized++;
+            }
+            else
+            {
+                self->statistics.n_exhausted++;
+            }
+
+            return FALSE;
+        }
+    }
+
+    meet_frontiers (self);
+    narrow_frontiers (self);
+
+    length = from_start->n_layers + from_end->n_layers - 2;
+
+    y   = self->start / self->size;
+    x   = self->start % self->size;
+    pos = emit_cell (self, self->path_digits, y, x);
+
+    for (i = 1; i < length; i++)
+    {
+        search = i < from_start->n_layers ? from_start : from_end;
+        layer  = &search->layers[i < from_start->n_layers ? i : length - i];
+
+        /* when none of the others is, the last neighbour is on the path */
+        for (k = 0; k < CSCOIN_GRID_N_DIRECTIONS - 1; k++)
+        {
+            if (test_frontier (self, search, layer, y + NEIGHBOUR_ROWS[k], x + NEIGHBOUR_COLUMNS[k]))
+            {
+                break;
+            }
+        }
+
+        y  += NEIGHBOUR_ROWS[k];
+        x  += NEIGHBOUR_COLUMNS[k];
+        pos = emit_cell (self, pos, y, x);
+    }
+
+    pos = emit_cell (self, pos, self->end / self->size, self->end % self->size);
+
+    self->path_digits_length = pos - self->path_digits;
+
+    self->statistics.n_solved++;
+
+    return TRUE;
+}
+
+void
+cscoin_grid_statistics_add (CSCoinGridStatistics *self, const CSCoinGridStatistics *other)
+{
+    self->n_solved    += other->n_solved;
+    self->n_enclosed  += other->n_enclosed;
+    self->n_exhausted += other->n_exhausted;
+    self->n_oversized += other->n_oversized;
+}
@@ -0,0 +1,108 @@
+#ifndef __CSCOIN_GRID_H__
+#define __CSCOIN_GRID_H__
+
+#include <glib.h>
+
+#include "cscoin-arena.h"
+#include "cscoin-mt64.h"
+
+G_BEGIN_DECLS
+
+/* cells are numbered 'y * size + x' in a gint */
+#define CSCOIN_GRID_MAX_SIZE 46340
+
+typedef struct _CSCoinGridLayer CSCoinGridLayer;
+
+/* rows 'row_min' to 'row_max' of a frontier, one after the other in 'rows' */
+struct _CSCoinGridLayer
+{
+    gint     row_min;
+    gint     row_max;
+    guint64 *rows;
+};
+
+typedef struct _CSCoinGridSearch CSCoinGridSearch;
+
+/* one side of the search, with its frontiers one per distance to its origin */
+struct _CSCoinGridSearch
+{
+    guint64         *visited;
+    CSCoinGridLayer *layers;
+    gsize            n_layers;
+};
+
+typedef struct _CSCoinGridStatistics CSCoinGridStatistics;
+
+/*
+ * Grids are rejected either because a wall of blockers surrounds the start
+ * or the end, or because one side of the search ran out of cells to visit.
+ * Those whose search outgrew the memory left to its arena are skipped.
+ */
+struct _CSCoinGridStatistics
+{
+    guint64 n_solved;
+    guint64 n_enclosed;
+    guint64 n_exhausted;
+    guint64 n_oversized;
+};
+
+typedef struct _CSCoinGrid CSCoinGrid;
+
+/*
+ * A square grid as bitsets with one bit per cell: row 'y' spans
+ * 'words_per_row' words and column 'x' is bit 'x % 64' of its word 'x / 64'.
+ * Cells are numbered 'y * size + x'.
+ *
+ * The start and the end are kept as cells, so a tile is blank if it is
+ * neither of them nor set in 'blockers'.
+ *
+ * Coordinates are reduced from the MT64 outputs in 'draws' with the 128-bit
+ * fixed-point 'size_reciprocal', low word first, rather than divided.
+ *
+ * A solved path is kept only as 'path_digits': the decimal row and column of
+ * each of its cells from the start to the end, concatenated in the order
+ * they are hashed. Each coordinate is copied from its slot in 'coordinates'.
+ *
+ * Everything is carved from 'arena'. The grid itself lives until the arena
+ * is cleared, and the frontiers of a search until the next one resets it.
+ */
+struct _CSCoinGrid
+{
+    CSCoinArena          *arena;
+    gint                  size;
+    gint                  words_per_row;
+    guint64              *blockers;
+    guint64              *empty_row;
+    guint64              *spread_row;
+    guint64              *draws;
+    gsize                 n_draws;
+    gsize                 draw_index;
+    guint64               size_reciprocal[2];
+    guint32               start;
+    guint32               end;
+
+    CSCoinGridSearch      from_start;
+    CSCoinGridSearch      from_end;
+
+    gchar                *coordinates;
+    gchar                *path_digits;
+    gsize                 path_digits_length;
+
+    CSCoinGridStatistics  statistics;
+};
+
+gsize    cscoin_grid_get_arena_size (gint                        size);
+void     cscoin_grid_init           (CSCoinGrid                 *self,
+                                     gint                        size,
+                                     CSCoinArena                *arena);
+void     cscoin_grid_generate       (CSCoinGrid                 *self,
+                                     CSCoinMT64                 *mt64,
+                                     gint                        nb_blockers);
+gboolean cscoin_grid_solve          (CSCoinGrid                 *self);
+
+void     cscoin_grid_statistics_add (CSCoinGridStatistics       *self,
+                                     const CSCoinGridStatistics *other);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_GRID_H__ */
@@ -0,0 +1,62 @@
+/**
+ * Serves the telemetry of the solver on '/metrics' in the text format of
+ * Prometheus. Stage timings only cover the sampled nonces, so they are
+ * meant to be divided by 'cscoin_sampled_nonces_total'.
+ */
+public class CSCoin.MetricsServer : Soup.Server
+{
+	public MetricsServer ()
+	{
+		Object ();
+		add_handler ("/metrics", handle_metrics);
+	}
+
+	private void handle_metrics (Soup.Server                server,
+	                             Soup.Message               msg,
+	                             string                     path,
+	                             HashTable<string, string>? query,
+	                             Soup.ClientContext         client)
+	{
+		var body = format_metrics ();
+		msg.set_status (Soup.Status.OK);
+		msg.set_response ("text/plain; version=0.0.4", Soup.MemoryUse.COPY, body.data);
+	}
+
+	public static string format_metrics ()
+	{
+		var metrics = new StringBuilder ();
+
+		Telemetry telemetry;
+		get_telemetry (out telemetry);
+
+		metrics.append ("# HELP cscoin_nonces_total Nonces tried by the solver.\n");
+		metrics.append ("# TYPE cscoin_nonces_total counter\n");
+		metrics.append_printf ("cscoin_nonces_total %" + uint64.FORMAT + "\n", telemetry.n_nonces);
+
+		metrics.append ("# HELP cscoin_worker_nonces_total Nonces tried by each worker since it was started.\n");
+		metrics.append ("# TYPE cscoin_worker_nonces_total counter\n");
+		for (uint i = 0; i < get_n_workers (); i++)
+		{
+			Telemetry worker_telemetry;
+			if (get_worker_telemetry (i, out worker_telemetry))
+			{
+				metrics.append_printf ("cscoin_worker_nonces_total{worker=\"%u\"} %" + uint64.FORMAT + "\n", i, worker_telemetry.n_nonces);
+			}
+		}
+
+		metrics.append ("# HELP cscoin_sampled_nonces_total Nonces whose stages were timed.\n");
+		metrics.append ("# TYPE cscoin_sampled_nonces_total counter\n");
+		metrics.append_printf ("cscoin_sampled_nonces_total %" + uint64.FORMAT + "\n", telemetry.n_sampled_nonces);
+
+		metrics.append ("# HELP cscoin_stage_seconds_total Time the sampled nonces spent in each stage.\n");
+		metrics.append ("# TYPE cscoin_stage_seconds_total counter\n");
+		for (var stage = 0; stage < TelemetryStage.N_STAGES; stage++)
+		{
+			metrics.append_printf ("cscoin_stage_seconds_total{stage=\"%s\"} %.9f\n",
+			                       ((TelemetryStage) stage).get_name (),
+			                       telemetry.stage_cycles[stage] / Telemetry.get_cycles_per_second ());
+		}
+
+		return metrics.str;
+	}
+}
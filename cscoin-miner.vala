@@ -35,16 +35,54 @@ namespace CSCoin
 	 */
 	string wallet_path;
 
+	/**
+	 * Order in which nonces are tried, either 'scramble' or 'odometer'.
+	 */
+	string nonce_strategy_nick;
+
+	NonceStrategy nonce_strategy;
+
+	/**
+	 * Memory the solver may take for a challenge, in MiB, or 0 for no limit.
+	 */
+	int memory_budget;
+
+	/**
+	 * Where the workers run, either 'all-threads', 'physical-cores' or
+	 * 'unpinned'.
+	 */
+	string placement_nick;
+
+	/**
+	 * Seconds between two reports of the hash rate, or 0 for none.
+	 */
+	int telemetry_interval;
+
+	/**
+	 * Local port serving the metrics of the solver, or 0 for none.
+	 */
+	int metrics_port;
+
 	const OptionEntry[] options =
 	{
-		{"wallet", 'w', 0, OptionArg.FILENAME, ref wallet_path, "Path to the wallet.", "FILE"},
+		{"wallet",             'w', 0, OptionArg.FILENAME, ref wallet_path,         "Path to the wallet.",                "FILE"},
+		{"nonce-strategy",     'n', 0, OptionArg.STRING,   ref nonce_strategy_nick, "Order in which nonces are tried.",   "STRATEGY"},
+		{"memory-budget",      'm', 0, OptionArg.INT,      ref memory_budget,       "Memory the solver may take.",        "MIB"},
+		{"placement",          'p', 0, OptionArg.STRING,   ref placement_nick,      "Where the workers run.",             "PLACEMENT"},
+		{"telemetry-interval", 't', 0, OptionArg.INT,      ref telemetry_interval,  "Seconds between hash rate reports.", "SECONDS"},
+		{"metrics-port",       0,   0, OptionArg.INT,      ref metrics_port,        "Local port serving the metrics.",    "PORT"},
 		{null}
 	};
 
 	int main (string[] args)
 	{
 		// default options
-		wallet_path = "default.pem";
+		wallet_path         = "default.pem";
+		nonce_strategy_nick = "scramble";
+		memory_budget       = 1024;
+		placement_nick      = "all-threads";
+		telemetry_interval  = 60;
+		metrics_port        = 0;
 
 		try
 		{
@@ -57,9 +95,59 @@ namespace CSCoin
 			return 1;
 		}
 
+		unowned EnumValue? nonce_strategy_value = ((EnumClass) typeof (NonceStrategy).class_ref ()).get_value_by_nick (nonce_strategy_nick);
+		if (nonce_strategy_value == null)
+		{
+			stderr.printf ("Unknown nonce strategy '%s'.\n", nonce_strategy_nick);
+			return 1;
+		}
+
+		nonce_strategy = (NonceStrategy) nonce_strategy_value.value;
+
+		if (memory_budget < 0)
+		{
+			stderr.printf ("The memory budget cannot be negative.\n");
+			return 1;
+		}
+
+		set_memory_budget ((size_t) memory_budget * 1024 * 1024);
+
+		unowned EnumValue? placement_value = ((EnumClass) typeof (Placement).class_ref ()).get_value_by_nick (placement_nick);
+		if (placement_value == null)
+		{
+			stderr.printf ("Unknown placement '%s'.\n", placement_nick);
+			return 1;
+		}
+
+		set_placement ((Placement) placement_value.value);
+
+		if (telemetry_interval < 0)
+		{
+			stderr.printf ("The telemetry interval cannot be negative.\n");
+			return 1;
+		}
+
+		if (metrics_port < 0 || metrics_port > uint16.MAX)
+		{
+			stderr.printf ("The metrics port %d is not a valid port.\n", metrics_port);
+			return 1;
+		}
+
+		message ("Using the '%s' SHA-256 backend and the '%s' seed kernel (%u lanes).",
+		         SHA256.get_backend_name (),
+		         SHA256.get_seed_batch_backend_name (),
+		         SHA256.get_seed_batch_lanes ());
+		message ("Using the '%s' MT64 backend.", MT64.get_backend_name ());
+		message ("Using the '%s' nonce strategy.", nonce_strategy_nick);
+		message ("Using %u workers placed on '%s'.", get_n_workers (), placement_nick);
+		if (memory_budget > 0)
+		{
+			message ("Solving within a memory budget of %dMiB.", memory_budget);
+		}
+
 		if (args.length < 2)
 		{
-			stderr.printf ("Usage: %s [--wallet=<wallet_file>] <ws_url>\n", args[0]);
+			stderr.printf ("Usage: %s [--wallet=<wallet_file>] [--nonce-strategy=<scramble|odometer>] [--memory-budget=<MiB>] [--placement=<all-threads|physical-cores|unpinned>] [--telemetry-interval=<seconds>] [--metrics-port=<port>] <ws_url>\n", args[0]);
 			return 1;
 		}
 
@@ -77,6 +165,26 @@ namespace CSCoin
 
 		message ("The 'wallet_id' is '%s'.", wallet.get_wallet_id ());
 
+		if (telemetry_interval > 0)
+		{
+			report_telemetry.begin ();
+		}
+
+		MetricsServer? metrics_server = null;
+		if (metrics_port > 0)
+		{
+			try
+			{
+				metrics_server = new MetricsServer ();
+				metrics_server.listen_local (metrics_port, Soup.ServerListenOptions.IPV4_ONLY);
+				message ("Serving the metrics on 'http://127.0.0.1:%d/metrics'.", metrics_port);
+			}
+			catch (Error err)
+			{
+				critical ("Could not serve the metrics on port %d: %s", metrics_port, err.message);
+			}
+		}
+
 		loop.begin (args[1], wallet);
 
 		new MainLoop ().run ();
@@ -84,6 +192,50 @@ namespace CSCoin
 		return 0;
 	}
 
+	/*
+	 * Log the hash rate over each interval and what a nonce took on average
+	 * in each stage of the solver.
+	 */
+	async void report_telemetry ()
+	{
+		Telemetry last;
+		get_telemetry (out last);
+		var last_time = get_monotonic_time ();
+
+		while (true)
+		{
+			Timeout.add_seconds (telemetry_interval, report_telemetry.callback);
+			yield;
+
+			Telemetry telemetry;
+			get_telemetry (out telemetry);
+			var now = get_monotonic_time ();
+
+			var n_nonces         = telemetry.n_nonces - last.n_nonces;
+			var n_sampled_nonces = telemetry.n_sampled_nonces - last.n_sampled_nonces;
+			var nonces_per_second = n_nonces * (double) TimeSpan.SECOND / (now - last_time);
+
+			var stages = new StringBuilder ();
+			for (var stage = 0; stage < TelemetryStage.N_STAGES; stage++)
+			{
+				var stage_cycles = telemetry.stage_cycles[stage] - last.stage_cycles[stage];
+				stages.append_printf ("%s%s %.2fus",
+				                      stage == 0 ? "" : ", ",
+				                      ((TelemetryStage) stage).get_name (),
+				                      n_sampled_nonces > 0 ? stage_cycles * 1e6 / Telemetry.get_cycles_per_second () / n_sampled_nonces : 0);
+			}
+
+			message ("Tried %.0f nonces/s (%.0f per worker) over the last %ds, taking per nonce: %s.",
+			         nonces_per_second,
+			         nonces_per_second / get_n_workers (),
+			         telemetry_interval,
+			         stages.str);
+
+			last      = telemetry;
+			last_time = now;
+		}
+	}
+
 	async void loop (string ws_url, Wallet wallet)
 	{
 		var ws_session = new Soup.Session ();
@@ -99,6 +251,9 @@ namespace CSCoin
 
 			var started = get_monotonic_time ();
 
+			GridStatistics grid_statistics_before;
+			get_grid_statistics (out grid_statistics_before);
+
 			string? nonce;
 			try
 			{
@@ -107,6 +262,7 @@ namespace CSCoin
 				                         challenge.last_solution_hash,
 				                         challenge.hash_prefix,
 				                         challenge.parameters,
+				                         nonce_strategy,
 				                         challenge.cancellable);
 
 				if (nonce == null)
@@ -124,6 +280,14 @@ namespace CSCoin
 					message ("Submitting nonce '%s' for challenge #%lld to authority...", nonce, challenge.challenge_id);
 					ws.send_text (generate_command ("submission", wallet_id: wallet.get_wallet_id (),
 					                                              nonce:     nonce.to_string ()));
+
+					/* if the authority takes this solution, the next challenge builds on
+					 * its hash, so the workers get ready for it in the meantime */
+					var solution_hash = get_solution_hash ();
+					if (solution_hash != null)
+					{
+						prepare_challenge (solution_hash, challenge.challenge_type, challenge.parameters);
+					}
 				}
 			}
 			catch (IOError.CANCELLED err)
@@ -134,6 +298,21 @@ namespace CSCoin
 			{
 				critical ("%s (%s, %d)", err.message, err.domain.to_string (), err.code);
 			}
+
+			if (challenge.challenge_type == ChallengeType.SHORTEST_PATH)
+			{
+				GridStatistics grid_statistics;
+				get_grid_statistics (out grid_statistics);
+
+				message ("Walked %llu grids for challenge #%lld: %llu solved, %llu with a walled-in start or end, %llu with no path between them and %llu skipped for lack of memory.",
+				         (grid_statistics.n_solved + grid_statistics.n_enclosed + grid_statistics.n_exhausted + grid_statistics.n_oversized) -
+				         (grid_statistics_before.n_solved + grid_statistics_before.n_enclosed + grid_statistics_before.n_exhausted + grid_statistics_before.n_oversized),
+				         challenge.challenge_id,
+				         grid_statistics.n_solved - grid_statistics_before.n_solved,
+				         grid_statistics.n_enclosed - grid_statistics_before.n_enclosed,
+				         grid_statistics.n_exhausted - grid_statistics_before.n_exhausted,
+				         grid_statistics.n_oversized - grid_statistics_before.n_oversized);
+			}
 		}, 1, true);
 
 		Challenge? current_challenge = null;
@@ -161,7 +340,16 @@ namespace CSCoin
 
 				if (response.has_member ("challenge_id"))
 				{
-					var challenge = new Challenge.from_json_object (response, new Cancellable ());
+					Challenge challenge;
+					try
+					{
+						challenge = new Challenge.from_json_object (response, new Cancellable ());
+					}
+					catch (IOError err)
+					{
+						critical ("%s (%s, %d)", err.message, err.domain.to_string (), err.code);
+						return;
+					}
 
 					if (current_challenge != null)
 					{
@@ -3,6 +3,11 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define CSCOIN_MT64_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
 #define CSCOIN_MT64_W 64
 #define CSCOIN_MT64_N 312
 #define CSCOIN_MT64_M 156
@@ -20,10 +25,29 @@
 #define CSCOIN_MT64_UPPER_MASK UINT64_C (0xFFFFFFFF80000000)
 #define CSCOIN_MT64_LOWER_MASK UINT64_C (0x7FFFFFFF)
 
+/* words twisted ahead when single outputs are drawn past the prepared ones */
+#define CSCOIN_MT64_LAZY_CHUNK 16
+
+typedef struct _CSCoinMT64Backend CSCoinMT64Backend;
+
+struct _CSCoinMT64Backend
+{
+    const gchar *name;
+    void (*twist)     (guint64 *mt, gint from, gint to);
+    void (*temper)    (const guint64 *mt, guint64 *numbers, gsize n_numbers);
+    void (*seed_xn)   (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to);
+    void (*twist_xn)  (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to);
+    void (*temper_xn) (const guint64 (*mt)[CSCOIN_MT64XN_LANES], guint64 *numbers, gsize n_numbers, gsize stride);
+};
+
 CSCoinMT64 *
 cscoin_mt64_new (void)
 {
-    return g_malloc0 (sizeof (CSCoinMT64));
+    CSCoinMT64 *self = g_malloc (sizeof (CSCoinMT64));
+
+    cscoin_mt64_init (self);
+
+    return self;
 }
 
 void
@@ -35,57 +59,542 @@ cscoin_mt64_free (CSCoinMT64 *self)
 void
 cscoin_mt64_init (CSCoinMT64 *self)
 {
-    self->index = 0;
+    self->index   = 0;
+    self->twisted = CSCOIN_MT64_N;
+    self->seeded  = CSCOIN_MT64_N;
     memset(self->mt, 0, sizeof (self->mt));
 }
 
+/*
+ * The state is derived lazily: output 'i' of the first twist only depends on
+ * 'mt[i]', 'mt[i + 1]' and 'mt[i + M]', so drawing K outputs only needs the
+ * first K + M seed words and K twisted words.
+ */
 void
 cscoin_mt64_set_seed (CSCoinMT64 *self, guint64 seed)
+{
+    self->index   = 0;
+    self->twisted = 0;
+    self->seeded  = 1;
+    self->mt[0]   = seed;
+}
+
+static void
+seed_range (guint64 *mt, gint from, gint to)
+{
+    gint i;
+
+    for (i = from; i < to; i++)
+    {
+        mt[i] = CSCOIN_MT64_F * (mt[i - 1] ^ (mt[i - 1] >> (CSCOIN_MT64_W - 2))) + i;
+    }
+}
+
+static inline guint64
+twist_word (guint64 mt_i, guint64 mt_i_1, guint64 mt_i_m)
+{
+    guint64 x = (mt_i & CSCOIN_MT64_UPPER_MASK) | (mt_i_1 & CSCOIN_MT64_LOWER_MASK);
+
+    return mt_i_m ^ (x >> 1) ^ (-(x & 1) & CSCOIN_MT64_A);
+}
+
+static inline guint64
+temper_word (guint64 y)
+{
+    y ^= (y >> CSCOIN_MT64_U) & CSCOIN_MT64_D;
+    y ^= (y << CSCOIN_MT64_S) & CSCOIN_MT64_B;
+    y ^= (y << CSCOIN_MT64_T) & CSCOIN_MT64_C;
+    y ^= (y >> CSCOIN_MT64_L);
+
+    return y;
+}
+
+/*
+ * The twist is split where 'i + M' and 'i + 1' wrap around, so that none of
+ * the three segments needs a modulo. Words are twisted in order, so a range
+ * starting where the previous one ended sees the same state as a full pass.
+ */
+static void
+twist_scalar (guint64 *mt, gint from, gint to)
 {
     gint i;
 
-    self->index = CSCOIN_MT64_N;
-    self->mt[0] = seed;
+    for (i = from; i < MIN (to, CSCOIN_MT64_N - CSCOIN_MT64_M); i++)
+    {
+        mt[i] = twist_word (mt[i], mt[i + 1], mt[i + CSCOIN_MT64_M]);
+    }
+
+    for (; i < MIN (to, CSCOIN_MT64_N - 1); i++)
+    {
+        mt[i] = twist_word (mt[i], mt[i + 1], mt[i + CSCOIN_MT64_M - CSCOIN_MT64_N]);
+    }
 
-    for (i = 1; i < CSCOIN_MT64_N; i++)
+    if (i < to)
     {
-        self->mt[i] = CSCOIN_MT64_F * (self->mt[i - 1] ^ (self->mt[i - 1] >> (CSCOIN_MT64_W - 2))) + i;
+        mt[CSCOIN_MT64_N - 1] = twist_word (mt[CSCOIN_MT64_N - 1], mt[0], mt[CSCOIN_MT64_M - 1]);
     }
 }
 
-guint64
-cscoin_mt64_next_uint64 (CSCoinMT64 *self)
+static void
+temper_scalar (const guint64 *mt, guint64 *numbers, gsize n_numbers)
+{
+    gsize i;
+
+    for (i = 0; i < n_numbers; i++)
+    {
+        numbers[i] = temper_word (mt[i]);
+    }
+}
+
+/*
+ * The interleaved variants run CSCOIN_MT64XN_LANES independent generators,
+ * word 'i' of lane 'l' being stored at 'mt[i][l]'. Each step is the scalar
+ * one applied across a row, so the serial seeding chain of one generator
+ * overlaps with the chains of the others.
+ */
+static void
+seed_xn_scalar (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to)
+{
+    gint i, lane;
+
+    for (i = from; i < to; i++)
+    {
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane++)
+        {
+            mt[i][lane] = CSCOIN_MT64_F * (mt[i - 1][lane] ^ (mt[i - 1][lane] >> (CSCOIN_MT64_W - 2))) + i;
+        }
+    }
+}
+
+static inline gint
+twist_source (gint i)
+{
+    return i < CSCOIN_MT64_N - CSCOIN_MT64_M ? i + CSCOIN_MT64_M : i + CSCOIN_MT64_M - CSCOIN_MT64_N;
+}
+
+static void
+twist_xn_scalar (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to)
+{
+    gint i, lane;
+
+    for (i = from; i < MIN (to, CSCOIN_MT64_N - 1); i++)
+    {
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane++)
+        {
+            mt[i][lane] = twist_word (mt[i][lane], mt[i + 1][lane], mt[twist_source (i)][lane]);
+        }
+    }
+
+    if (i < to)
+    {
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane++)
+        {
+            mt[i][lane] = twist_word (mt[i][lane], mt[0][lane], mt[CSCOIN_MT64_M - 1][lane]);
+        }
+    }
+}
+
+static void
+temper_xn_scalar (const guint64 (*mt)[CSCOIN_MT64XN_LANES], guint64 *numbers, gsize n_numbers, gsize stride)
+{
+    gsize i;
+    gint lane;
+
+    for (i = 0; i < n_numbers; i++)
+    {
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane++)
+        {
+            numbers[lane * stride + i] = temper_word (mt[i][lane]);
+        }
+    }
+}
+
+#ifdef CSCOIN_MT64_HAVE_X86
+
+__attribute__ ((target ("avx2")))
+static inline __m256i
+twist_avx2_4 (__m256i mt_i, __m256i mt_i_1, __m256i mt_i_m)
+{
+    __m256i x   = _mm256_or_si256 (_mm256_and_si256 (mt_i, _mm256_set1_epi64x (CSCOIN_MT64_UPPER_MASK)),
+                                   _mm256_and_si256 (mt_i_1, _mm256_set1_epi64x (CSCOIN_MT64_LOWER_MASK)));
+    __m256i mag = _mm256_and_si256 (_mm256_sub_epi64 (_mm256_setzero_si256 (),
+                                                      _mm256_and_si256 (x, _mm256_set1_epi64x (1))),
+                                    _mm256_set1_epi64x (CSCOIN_MT64_A));
+
+    return _mm256_xor_si256 (mt_i_m, _mm256_xor_si256 (_mm256_srli_epi64 (x, 1), mag));
+}
+
+/*
+ * Four words at a time: every vector reads 'mt[i + 1 .. i + 4]' before it
+ * stores 'mt[i .. i + 3]', and the second segment only reads words that the
+ * first one already rewrote, so the dependencies match the scalar loop.
+ */
+__attribute__ ((target ("avx2")))
+static void
+twist_avx2 (guint64 *mt, gint from, gint to)
 {
     gint i;
-    guint64 x;
-    guint64 x_a;
-    guint64 y;
+    gint end;
+
+    end = MIN (to, CSCOIN_MT64_N - CSCOIN_MT64_M);
+    for (i = from; i + 4 <= end; i += 4)
+    {
+        _mm256_storeu_si256 ((__m256i *) &mt[i],
+                             twist_avx2_4 (_mm256_loadu_si256 ((const __m256i *) &mt[i]),
+                                           _mm256_loadu_si256 ((const __m256i *) &mt[i + 1]),
+                                           _mm256_loadu_si256 ((const __m256i *) &mt[i + CSCOIN_MT64_M])));
+    }
+
+    if (i < end)
+    {
+        twist_scalar (mt, i, end);
+        i = end;
+    }
+
+    end = MIN (to, CSCOIN_MT64_N - 1);
+    for (; i + 4 <= end; i += 4)
+    {
+        _mm256_storeu_si256 ((__m256i *) &mt[i],
+                             twist_avx2_4 (_mm256_loadu_si256 ((const __m256i *) &mt[i]),
+                                           _mm256_loadu_si256 ((const __m256i *) &mt[i + 1]),
+                                           _mm256_loadu_si256 ((const __m256i *) &mt[i + CSCOIN_MT64_M - CSCOIN_MT64_N])));
+    }
+
+    twist_scalar (mt, i, to);
+}
+
+__attribute__ ((target ("avx2")))
+static void
+temper_avx2 (const guint64 *mt, guint64 *numbers, gsize n_numbers)
+{
+    __m256i y;
+    gsize i;
+
+    for (i = 0; i + 4 <= n_numbers; i += 4)
+    {
+        y = _mm256_loadu_si256 ((const __m256i *) &mt[i]);
+        y = _mm256_xor_si256 (y, _mm256_and_si256 (_mm256_srli_epi64 (y, CSCOIN_MT64_U), _mm256_set1_epi64x (CSCOIN_MT64_D)));
+        y = _mm256_xor_si256 (y, _mm256_and_si256 (_mm256_slli_epi64 (y, CSCOIN_MT64_S), _mm256_set1_epi64x (CSCOIN_MT64_B)));
+        y = _mm256_xor_si256 (y, _mm256_and_si256 (_mm256_slli_epi64 (y, CSCOIN_MT64_T), _mm256_set1_epi64x (CSCOIN_MT64_C)));
+        y = _mm256_xor_si256 (y, _mm256_srli_epi64 (y, CSCOIN_MT64_L));
+        _mm256_storeu_si256 ((__m256i *) &numbers[i], y);
+    }
+
+    temper_scalar (mt + i, numbers + i, n_numbers - i);
+}
+
+/* there is no 64-bit 'vpmullq' before AVX-512DQ, so the product is built from 32-bit halves */
+__attribute__ ((target ("avx2")))
+static inline __m256i
+mullo_epi64_avx2 (__m256i x, guint64 factor)
+{
+    __m256i lo    = _mm256_set1_epi64x (factor & 0xFFFFFFFF);
+    __m256i hi    = _mm256_set1_epi64x (factor >> 32);
+    __m256i cross = _mm256_add_epi64 (_mm256_mul_epu32 (x, hi), _mm256_mul_epu32 (_mm256_srli_epi64 (x, 32), lo));
+
+    return _mm256_add_epi64 (_mm256_mul_epu32 (x, lo), _mm256_slli_epi64 (cross, 32));
+}
+
+__attribute__ ((target ("avx2")))
+static void
+seed_xn_avx2 (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to)
+{
+    __m256i x, y;
+    gint i;
+
+    /*
+     * Two independent vectors per row keep both multiply chains in flight,
+     * which also beats a single AVX-512 chain of the slow 'vpmullq'.
+     */
+    x = _mm256_loadu_si256 ((const __m256i *) &mt[from - 1][0]);
+    y = _mm256_loadu_si256 ((const __m256i *) &mt[from - 1][4]);
+
+    for (i = from; i < to; i++)
+    {
+        x = _mm256_add_epi64 (mullo_epi64_avx2 (_mm256_xor_si256 (x, _mm256_srli_epi64 (x, CSCOIN_MT64_W - 2)), CSCOIN_MT64_F),
+                              _mm256_set1_epi64x (i));
+        y = _mm256_add_epi64 (mullo_epi64_avx2 (_mm256_xor_si256 (y, _mm256_srli_epi64 (y, CSCOIN_MT64_W - 2)), CSCOIN_MT64_F),
+                              _mm256_set1_epi64x (i));
+        _mm256_storeu_si256 ((__m256i *) &mt[i][0], x);
+        _mm256_storeu_si256 ((__m256i *) &mt[i][4], y);
+    }
+}
+
+__attribute__ ((target ("avx2")))
+static void
+twist_xn_avx2 (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to)
+{
+    gint i, next, lane;
+
+    for (i = from; i < to; i++)
+    {
+        next = i < CSCOIN_MT64_N - 1 ? i + 1 : 0;
+
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane += 4)
+        {
+            _mm256_storeu_si256 ((__m256i *) &mt[i][lane],
+                                 twist_avx2_4 (_mm256_loadu_si256 ((const __m256i *) &mt[i][lane]),
+                                               _mm256_loadu_si256 ((const __m256i *) &mt[next][lane]),
+                                               _mm256_loadu_si256 ((const __m256i *) &mt[twist_source (i)][lane])));
+        }
+    }
+}
+
+__attribute__ ((target ("avx2")))
+static void
+temper_xn_avx2 (const guint64 (*mt)[CSCOIN_MT64XN_LANES], guint64 *numbers, gsize n_numbers, gsize stride)
+{
+    guint64 row[CSCOIN_MT64XN_LANES] __attribute__ ((aligned (32)));
+    __m256i y;
+    gsize i;
+    gint lane;
 
-    if (G_UNLIKELY (self->index >= CSCOIN_MT64_N))
+    for (i = 0; i < n_numbers; i++)
     {
-        for (i = 0; i < CSCOIN_MT64_N; i++)
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane += 4)
         {
-            x = (self->mt[i] & CSCOIN_MT64_UPPER_MASK) + (self->mt[(i + 1) % CSCOIN_MT64_N] & CSCOIN_MT64_LOWER_MASK);
+            y = _mm256_loadu_si256 ((const __m256i *) &mt[i][lane]);
+            y = _mm256_xor_si256 (y, _mm256_and_si256 (_mm256_srli_epi64 (y, CSCOIN_MT64_U), _mm256_set1_epi64x (CSCOIN_MT64_D)));
+            y = _mm256_xor_si256 (y, _mm256_and_si256 (_mm256_slli_epi64 (y, CSCOIN_MT64_S), _mm256_set1_epi64x (CSCOIN_MT64_B)));
+            y = _mm256_xor_si256 (y, _mm256_and_si256 (_mm256_slli_epi64 (y, CSCOIN_MT64_T), _mm256_set1_epi64x (CSCOIN_MT64_C)));
+            y = _mm256_xor_si256 (y, _mm256_srli_epi64 (y, CSCOIN_MT64_L));
+            _mm256_store_si256 ((__m256i *) &row[lane], y);
+        }
+
+        for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane++)
+        {
+            numbers[lane * stride + i] = row[lane];
+        }
+    }
+}
+
+__attribute__ ((target ("avx512f")))
+static void
+twist_xn_avx512 (guint64 (*mt)[CSCOIN_MT64XN_LANES], gint from, gint to)
+{
+    __m512i x, y;
+    gint i, next;
+
+    for (i = from; i < to; i++)
+    {
+        next = i < CSCOIN_MT64_N - 1 ? i + 1 : 0;
+
+        x = _mm512_or_si512 (_mm512_and_si512 (_mm512_loadu_si512 ((const void *) &mt[i][0]), _mm512_set1_epi64 (CSCOIN_MT64_UPPER_MASK)),
+                             _mm512_and_si512 (_mm512_loadu_si512 ((const void *) &mt[next][0]), _mm512_set1_epi64 (CSCOIN_MT64_LOWER_MASK)));
+        y = _mm512_xor_si512 (_mm512_loadu_si512 ((const void *) &mt[twist_source (i)][0]), _mm512_srli_epi64 (x, 1));
+        y = _mm512_mask_xor_epi64 (y, _mm512_test_epi64_mask (x, _mm512_set1_epi64 (1)), y, _mm512_set1_epi64 (CSCOIN_MT64_A));
+
+        _mm512_storeu_si512 ((void *) &mt[i][0], y);
+    }
+}
+
+__attribute__ ((target ("avx512f")))
+static void
+temper_xn_avx512 (const guint64 (*mt)[CSCOIN_MT64XN_LANES], guint64 *numbers, gsize n_numbers, gsize stride)
+{
+    const __m512i offsets = _mm512_set_epi64 (7 * stride, 6 * stride, 5 * stride, 4 * stride,
+                                              3 * stride, 2 * stride, 1 * stride, 0);
+    __m512i y;
+    gsize i;
+
+    for (i = 0; i < n_numbers; i++)
+    {
+        y = _mm512_loadu_si512 ((const void *) &mt[i][0]);
+        y = _mm512_xor_si512 (y, _mm512_and_si512 (_mm512_srli_epi64 (y, CSCOIN_MT64_U), _mm512_set1_epi64 (CSCOIN_MT64_D)));
+        y = _mm512_xor_si512 (y, _mm512_and_si512 (_mm512_slli_epi64 (y, CSCOIN_MT64_S), _mm512_set1_epi64 (CSCOIN_MT64_B)));
+        y = _mm512_xor_si512 (y, _mm512_and_si512 (_mm512_slli_epi64 (y, CSCOIN_MT64_T), _mm512_set1_epi64 (CSCOIN_MT64_C)));
+        y = _mm512_xor_si512 (y, _mm512_srli_epi64 (y, CSCOIN_MT64_L));
+        _mm512_i64scatter_epi64 (numbers + i, offsets, y, 8);
+    }
+}
 
-            x_a = x >> 1;
+#endif /* CSCOIN_MT64_HAVE_X86 */
+
+static const CSCoinMT64Backend
+BACKENDS[] =
+{
+#ifdef CSCOIN_MT64_HAVE_X86
+    {"avx512", twist_avx2,   temper_avx2,   seed_xn_avx2,   twist_xn_avx512, temper_xn_avx512},
+    {"avx2",   twist_avx2,   temper_avx2,   seed_xn_avx2,   twist_xn_avx2,   temper_xn_avx2},
+#endif
+    {"scalar", twist_scalar, temper_scalar, seed_xn_scalar, twist_xn_scalar, temper_xn_scalar}
+};
 
-            if (x % 2)
-            {
-                x_a ^= CSCOIN_MT64_A;
-            }
+static const CSCoinMT64Backend *
+backend = NULL;
+
+static const CSCoinMT64Backend *
+get_backend (void)
+{
+    if (g_once_init_enter (&backend))
+    {
+        const CSCoinMT64Backend *selected_backend = &BACKENDS[G_N_ELEMENTS (BACKENDS) - 1];
 
-            self->mt[i] = self->mt[(i + CSCOIN_MT64_M) % CSCOIN_MT64_N] ^ x_a;
+#ifdef CSCOIN_MT64_HAVE_X86
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx512f"))
+        {
+            selected_backend = &BACKENDS[0];
+        }
+        else if (__builtin_cpu_supports ("avx2"))
+        {
+            selected_backend = &BACKENDS[1];
         }
+#endif
+
+        g_once_init_leave (&backend, selected_backend);
+    }
+
+    return backend;
+}
 
+const gchar *
+cscoin_mt64_get_backend_name (void)
+{
+    return get_backend ()->name;
+}
+
+/*
+ * Make at least one and up to 'count' outputs available from 'self->index',
+ * seeding and twisting only the words they depend on.
+ */
+static void
+prepare (CSCoinMT64 *self, const CSCoinMT64Backend *mt64_backend, gint count)
+{
+    gint end;
+    gint seeded_end;
+
+    if (self->index >= CSCOIN_MT64_N)
+    {
+        mt64_backend->twist (self->mt, 0, CSCOIN_MT64_N);
         self->index = 0;
+        return;
     }
 
-    y = self->mt[self->index++];
+    end = MIN (self->index + count, CSCOIN_MT64_N);
 
-    y ^= (y >> CSCOIN_MT64_U) & CSCOIN_MT64_D;
-    y ^= (y << CSCOIN_MT64_S) & CSCOIN_MT64_B;
-    y ^= (y << CSCOIN_MT64_T) & CSCOIN_MT64_C;
-    y ^= (y >> CSCOIN_MT64_L);
+    if (end <= self->twisted)
+    {
+        return;
+    }
 
-    return y;
+    seeded_end = end <= CSCOIN_MT64_N - CSCOIN_MT64_M ? end + CSCOIN_MT64_M : CSCOIN_MT64_N;
+
+    if (seeded_end > self->seeded)
+    {
+        seed_range (self->mt, self->seeded, seeded_end);
+        self->seeded = seeded_end;
+    }
+
+    mt64_backend->twist (self->mt, self->twisted, end);
+    self->twisted = end;
+}
+
+guint64
+cscoin_mt64_next_uint64 (CSCoinMT64 *self)
+{
+    if (G_UNLIKELY (self->index >= self->twisted))
+    {
+        prepare (self, get_backend (), CSCOIN_MT64_LAZY_CHUNK);
+    }
+
+    return temper_word (self->mt[self->index++]);
+}
+
+/*
+ * Equivalent to calling cscoin_mt64_next_uint64() 'n_numbers' times, but the
+ * tempering runs over whole blocks of the state. Right after a seed, only
+ * the words needed for these 'n_numbers' outputs are computed.
+ */
+void
+cscoin_mt64_fill_uint64 (CSCoinMT64 *self, guint64 *numbers, gsize n_numbers)
+{
+    const CSCoinMT64Backend *mt64_backend = get_backend ();
+    gsize n;
+
+    while (n_numbers > 0)
+    {
+        prepare (self, mt64_backend, MIN (n_numbers, CSCOIN_MT64_N));
+
+        n = MIN (n_numbers, (gsize) (self->twisted - self->index));
+
+        mt64_backend->temper (self->mt + self->index, numbers, n);
+
+        self->index += n;
+        numbers     += n;
+        n_numbers   -= n;
+    }
+}
+
+void
+cscoin_mt64xn_set_seeds (CSCoinMT64xN *self, const guint64 *seeds, guint n_seeds)
+{
+    gint lane;
+
+    self->index   = 0;
+    self->twisted = 0;
+    self->seeded  = 1;
+
+    /* unused lanes still run, on a zero seed */
+    for (lane = 0; lane < CSCOIN_MT64XN_LANES; lane++)
+    {
+        self->mt[0][lane] = lane < n_seeds ? seeds[lane] : 0;
+    }
+}
+
+static void
+prepare_xn (CSCoinMT64xN *self, const CSCoinMT64Backend *mt64_backend, gint count)
+{
+    gint end;
+    gint seeded_end;
+
+    if (self->index >= CSCOIN_MT64_N)
+    {
+        mt64_backend->twist_xn (self->mt, 0, CSCOIN_MT64_N);
+        self->index = 0;
+        return;
+    }
+
+    end = MIN (self->index + count, CSCOIN_MT64_N);
+
+    if (end <= self->twisted)
+    {
+        return;
+    }
+
+    seeded_end = end <= CSCOIN_MT64_N - CSCOIN_MT64_M ? end + CSCOIN_MT64_M : CSCOIN_MT64_N;
+
+    if (seeded_end > self->seeded)
+    {
+        mt64_backend->seed_xn (self->mt, self->seeded, seeded_end);
+        self->seeded = seeded_end;
+    }
+
+    mt64_backend->twist_xn (self->mt, self->twisted, end);
+    self->twisted = end;
+}
+
+/*
+ * Draw the next 'n_numbers' outputs of every lane, lane 'l' being written
+ * contiguously at 'numbers + l * n_numbers'.
+ */
+void
+cscoin_mt64xn_fill_uint64 (CSCoinMT64xN *self, guint64 *numbers, gsize n_numbers)
+{
+    const CSCoinMT64Backend *mt64_backend = get_backend ();
+    gsize stride = n_numbers;
+    gsize n;
+
+    while (n_numbers > 0)
+    {
+        prepare_xn (self, mt64_backend, MIN (n_numbers, CSCOIN_MT64_N));
+
+        n = MIN (n_numbers, (gsize) (self->twisted - self->index));
+
+        mt64_backend->temper_xn ((const guint64 (*)[CSCOIN_MT64XN_LANES]) (self->mt + self->index), numbers, n, stride);
+
+        self->index += n;
+        numbers     += n;
+        n_numbers   -= n;
+    }
 }
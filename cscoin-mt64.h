@@ -5,19 +5,38 @@
 
 G_BEGIN_DECLS
 
+#define CSCOIN_MT64XN_LANES 8
+
 typedef struct _CSCoinMT64 CSCoinMT64;
 
 struct _CSCoinMT64
 {
     gint    index;
+    gint    twisted;
+    gint    seeded;
     guint64 mt[312];
 };
 
-CSCoinMT64 * cscoin_mt64_new         (void);
-void         cscoin_mt64_free        (CSCoinMT64 *self);
-void         cscoin_mt64_init        (CSCoinMT64 *self);
-void         cscoin_mt64_set_seed    (CSCoinMT64 *self, guint64 seed);
-guint64      cscoin_mt64_next_uint64 (CSCoinMT64 *self);
+typedef struct _CSCoinMT64xN CSCoinMT64xN;
+
+struct _CSCoinMT64xN
+{
+    gint    index;
+    gint    twisted;
+    gint    seeded;
+    guint64 mt[312][CSCOIN_MT64XN_LANES];
+};
+
+const gchar * cscoin_mt64_get_backend_name (void);
+CSCoinMT64 *  cscoin_mt64_new              (void);
+void          cscoin_mt64_free             (CSCoinMT64 *self);
+void          cscoin_mt64_init             (CSCoinMT64 *self);
+void          cscoin_mt64_set_seed         (CSCoinMT64 *self, guint64 seed);
+guint64       cscoin_mt64_next_uint64      (CSCoinMT64 *self);
+void          cscoin_mt64_fill_uint64      (CSCoinMT64 *self, guint64 *numbers, gsize n_numbers);
+
+void          cscoin_mt64xn_set_seeds      (CSCoinMT64xN *self, const guint64 *seeds, guint n_seeds);
+void          cscoin_mt64xn_fill_uint64    (CSCoinMT64xN *self, guint64 *numbers, gsize n_numbers);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (CSCoinMT64, cscoin_mt64_free);
 
@@ -0,0 +1,24 @@
+#include "cscoin-nonce-strategy.h"
+
+static const GEnumValue
+NONCE_STRATEGY_ENUM_VALUES[] =
+{
+    {0, "CSCOIN_NONCE_STRATEGY_SCRAMBLE", "scramble"},
+    {1, "CSCOIN_NONCE_STRATEGY_ODOMETER", "odometer"},
+    NULL
+};
+
+static GType
+cscoin_nonce_strategy = 0;
+
+GType
+cscoin_nonce_strategy_get_type ()
+{
+    if (g_once_init_enter (&cscoin_nonce_strategy))
+    {
+        GType cscoin_nonce_strategy_value = g_enum_register_static ("CSCoinNonceStrategy", NONCE_STRATEGY_ENUM_VALUES);
+        g_once_init_leave (&cscoin_nonce_strategy, cscoin_nonce_strategy_value);
+    }
+
+    return cscoin_nonce_strategy;
+}
@@ -0,0 +1,21 @@
+#ifndef __CSCOIN_NONCE_STRATEGY_H__
+#define __CSCOIN_NONCE_STRATEGY_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef enum _CSCoinNonceStrategy CSCoinNonceStrategy;
+
+enum _CSCoinNonceStrategy
+{
+    CSCOIN_NONCE_STRATEGY_SCRAMBLE,
+    CSCOIN_NONCE_STRATEGY_ODOMETER
+};
+
+#define CSCOIN_TYPE_NONCE_STRATEGY cscoin_nonce_strategy_get_type ()
+GType cscoin_nonce_strategy_get_type ();
+
+G_END_DECLS
+
+#endif /* __CSCOIN_NONCE_STRATEGY_H__ */
@@ -0,0 +1,127 @@
+#include "cscoin-nonce.h"
+
+#include <string.h>
+
+/* odd, so that multiplying positions by it walks every nonce exactly once */
+#define CSCOIN_NONCE_SCRAMBLE_STEP 15265499401763465969ULL
+
+/* the odometer only walks 20-digit nonces, so that their length never changes */
+#define CSCOIN_NONCE_ODOMETER_FROM 10000000000000000000ULL
+
+guint64
+cscoin_nonce_strategy_get_n_positions (CSCoinNonceStrategy strategy)
+{
+    switch (strategy)
+    {
+        case CSCOIN_NONCE_STRATEGY_SCRAMBLE:
+            return G_MAXUINT64;
+        case CSCOIN_NONCE_STRATEGY_ODOMETER:
+            return G_MAXUINT64 - CSCOIN_NONCE_ODOMETER_FROM + 1;
+        default:
+            g_return_val_if_reached (0);
+    }
+}
+
+static inline guint64
+get_nonce (CSCoinNonceStrategy strategy, guint64 position)
+{
+    switch (strategy)
+    {
+        case CSCOIN_NONCE_STRATEGY_SCRAMBLE:
+            return (position + 1) * CSCOIN_NONCE_SCRAMBLE_STEP;
+        case CSCOIN_NONCE_STRATEGY_ODOMETER:
+            return CSCOIN_NONCE_ODOMETER_FROM + position;
+        default:
+            g_return_val_if_reached (0);
+    }
+}
+
+void
+cscoin_nonce_space_init (CSCoinNonceSpace    *self,
+                         CSCoinNonceStrategy  strategy,
+                         guint                n_lanes)
+{
+    g_return_if_fail (n_lanes > 0 && n_lanes <= CSCOIN_SHA256_MAX_LANES);
+
+    memset (&self->tails, 0, sizeof (self->tails));
+
+    self->strategy  = strategy;
+    self->n_lanes   = n_lanes;
+    self->position  = 0;
+    self->remaining = 0;
+    self->laid_out  = FALSE;
+}
+
+static void
+lay_out_nonce (CSCoinNonceSpace *self, guint lane, guint64 nonce)
+{
+    gsize nonce_len = cscoin_format_uint64 (nonce, self->nonces[lane]);
+
+    self->nonces[lane][nonce_len] = '\0';
+    cscoin_sha256_tail_batch_set_nonce (&self->tails, lane, self->nonces[lane], nonce_len);
+}
+
+void
+cscoin_nonce_space_seek (CSCoinNonceSpace *self, guint64 position, guint64 length)
+{
+    self->position  = position;
+    self->remaining = length;
+    self->laid_out  = FALSE;
+}
+
+/* add 'step' to a decimal string in place and return the first digit that changed */
+static gsize
+odometer_advance (gchar *digits, gsize len, guint step)
+{
+    guint carry = step;
+    gsize i = len;
+
+    while (carry > 0 && i > 0)
+    {
+        i--;
+        carry     += digits[i] - '0';
+        digits[i]  = '0' + carry % 10;
+        carry     /= 10;
+    }
+
+    return i;
+}
+
+/*
+ * Lay out the next batch of nonces and their tail blocks, and return how
+ * many lanes were filled, which is zero once the chunk is exhausted.
+ */
+guint
+cscoin_nonce_space_next_batch (CSCoinNonceSpace *self)
+{
+    guint n_lanes = MIN (self->n_lanes, self->remaining);
+    guint lane;
+    gsize from;
+
+    /*
+     * Odometer lanes start on consecutive nonces and each one advances by a
+     * whole batch, so only their last digits have to be rewritten.
+     */
+    if (self->strategy == CSCOIN_NONCE_STRATEGY_ODOMETER && self->laid_out)
+    {
+        for (lane = 0; lane < n_lanes; lane++)
+        {
+            from = odometer_advance (self->nonces[lane], CSCOIN_FORMAT_UINT64_MAX_LENGTH, self->n_lanes);
+            cscoin_sha256_tail_batch_patch_nonce (&self->tails, lane, self->nonces[lane], from, CSCOIN_FORMAT_UINT64_MAX_LENGTH);
+        }
+    }
+    else
+    {
+        for (lane = 0; lane < n_lanes; lane++)
+        {
+            lay_out_nonce (self, lane, get_nonce (self->strategy, self->position + lane));
+        }
+
+        self->laid_out = TRUE;
+    }
+
+    self->position  += n_lanes;
+    self->remaining -= n_lanes;
+
+    return n_lanes;
+}
@@ -0,0 +1,42 @@
+#ifndef __CSCOIN_NONCE_H__
+#define __CSCOIN_NONCE_H__
+
+#include <glib.h>
+
+#include "cscoin-format.h"
+#include "cscoin-nonce-strategy.h"
+#include "cscoin-sha256.h"
+
+G_BEGIN_DECLS
+
+typedef struct _CSCoinNonceSpace CSCoinNonceSpace;
+
+/*
+ * Walks the nonces at positions '[position, position + remaining)', a batch
+ * of 'n_lanes' at a time. Lane 'l' of the batch holds the nonce in
+ * 'nonces[l]' and its padded tail block in 'tails'.
+ */
+struct _CSCoinNonceSpace
+{
+    CSCoinSHA256TailBatch tails;
+    CSCoinNonceStrategy   strategy;
+    guint                 n_lanes;
+    guint64               position;
+    guint64               remaining;
+    gboolean              laid_out;
+    gchar                 nonces[CSCOIN_SHA256_MAX_LANES][CSCOIN_FORMAT_UINT64_MAX_LENGTH + 1];
+};
+
+guint64 cscoin_nonce_strategy_get_n_positions (CSCoinNonceStrategy  strategy);
+
+void    cscoin_nonce_space_init               (CSCoinNonceSpace    *self,
+                                               CSCoinNonceStrategy  strategy,
+                                               guint                n_lanes);
+void    cscoin_nonce_space_seek               (CSCoinNonceSpace    *self,
+                                               guint64              position,
+                                               guint64              length);
+guint   cscoin_nonce_space_next_batch         (CSCoinNonceSpace    *self);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_NONCE_H__ */
@@ -0,0 +1,25 @@
+#include "cscoin-placement.h"
+
+static const GEnumValue
+PLACEMENT_ENUM_VALUES[] =
+{
+    {0, "CSCOIN_PLACEMENT_ALL_THREADS",    "all-threads"},
+    {1, "CSCOIN_PLACEMENT_PHYSICAL_CORES", "physical-cores"},
+    {2, "CSCOIN_PLACEMENT_UNPINNED",       "unpinned"},
+    NULL
+};
+
+static GType
+cscoin_placement = 0;
+
+GType
+cscoin_placement_get_type ()
+{
+    if (g_once_init_enter (&cscoin_placement))
+    {
+        GType cscoin_placement_value = g_enum_register_static ("CSCoinPlacement", PLACEMENT_ENUM_VALUES);
+        g_once_init_leave (&cscoin_placement, cscoin_placement_value);
+    }
+
+    return cscoin_placement;
+}
@@ -0,0 +1,22 @@
+#ifndef __CSCOIN_PLACEMENT_H__
+#define __CSCOIN_PLACEMENT_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef enum _CSCoinPlacement CSCoinPlacement;
+
+enum _CSCoinPlacement
+{
+    CSCOIN_PLACEMENT_ALL_THREADS,
+    CSCOIN_PLACEMENT_PHYSICAL_CORES,
+    CSCOIN_PLACEMENT_UNPINNED
+};
+
+#define CSCOIN_TYPE_PLACEMENT cscoin_placement_get_type ()
+GType cscoin_placement_get_type ();
+
+G_END_DECLS
+
+#endif /* __CSCOIN_PLACEMENT_H__ */
@@ -0,0 +1,102 @@
+#include "cscoin-scheduler.h"
+
+/* long enough to amortize the claim, short enough to notice a cancellation */
+#define CSCOIN_SCHEDULER_CHUNK_DURATION (2 * G_TIME_SPAN_MILLISECOND)
+
+#define CSCOIN_SCHEDULER_MAX_CHUNK_LENGTH (G_GUINT64_CONSTANT (1) << 32)
+
+void
+cscoin_scheduler_init (CSCoinScheduler *self,
+                       guint64          n_positions,
+                       CSCoinTeam      *team)
+{
+    self->next_position = 0;
+    self->n_positions   = n_positions;
+    self->done          = FALSE;
+    self->team          = team;
+}
+
+void
+cscoin_scheduler_chunk_init (CSCoinSchedulerChunk *chunk, guint granularity)
+{
+    chunk->start       = 0;
+    chunk->length      = 0;
+    chunk->granularity = granularity;
+    chunk->claimed_at  = 0;
+}
+
+/*
+ * Scale the chunk so that the next one takes about
+ * CSCOIN_SCHEDULER_CHUNK_DURATION, by at most a factor of two each time so
+ * that a single slow chunk does not throw the estimate off.
+ */
+static guint64
+adapt_chunk_length (const CSCoinSchedulerChunk *chunk, gint64 now)
+{
+    gint64 elapsed = MAX (now - chunk->claimed_at, 1);
+    guint64 length;
+
+    if (chunk->length == 0)
+    {
+        return chunk->granularity;
+    }
+
+    if (elapsed < CSCOIN_SCHEDULER_CHUNK_DURATION / 2)
+    {
+        length = chunk->length * 2;
+    }
+    else if (elapsed > CSCOIN_SCHEDULER_CHUNK_DURATION * 2)
+    {
+        length = chunk->length / 2;
+    }
+    else
+    {
+        length = chunk->length * CSCOIN_SCHEDULER_CHUNK_DURATION / elapsed;
+    }
+
+    length = CLAMP (length, chunk->granularity, CSCOIN_SCHEDULER_MAX_CHUNK_LENGTH);
+
+    return length - length % chunk->granularity;
+}
+
+/*
+ * Claim the next chunk for a worker, which is the only point where it
+ * polls for cancellation. Returns FALSE once the search is over.
+ */
+gboolean
+cscoin_scheduler_next_chunk (CSCoinScheduler *self, CSCoinSchedulerChunk *chunk)
+{
+    gint64 now;
+
+    if (cscoin_scheduler_is_done (self) || cscoin_team_is_cancelled (self->team))
+    {
+        return FALSE;
+    }
+
+    now = g_get_monotonic_time ();
+
+    chunk->length     = adapt_chunk_length (chunk, now);
+    chunk->claimed_at = now;
+    chunk->start      = __atomic_fetch_add (&self->next_position, chunk->length, __ATOMIC_RELAXED);
+
+    if (G_UNLIKELY (chunk->start >= self->n_positions))
+    {
+        return FALSE;
+    }
+
+    chunk->length = MIN (chunk->length, self->n_positions - chunk->start);
+
+    return TRUE;
+}
+
+void
+cscoin_scheduler_stop (CSCoinScheduler *self)
+{
+    g_atomic_int_set (&self->done, TRUE);
+}
+
+gboolean
+cscoin_scheduler_is_done (CSCoinScheduler *self)
+{
+    return g_atomic_int_get (&self->done);
+}
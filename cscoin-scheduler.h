@@ -0,0 +1,48 @@
+#ifndef __CSCOIN_SCHEDULER_H__
+#define __CSCOIN_SCHEDULER_H__
+
+#include <glib.h>
+
+#include "cscoin-team.h"
+
+G_BEGIN_DECLS
+
+typedef struct _CSCoinScheduler CSCoinScheduler;
+
+/*
+ * Hands out chunks of the positions '[0, n_positions)' to the members of
+ * 'team' as they ask for them, so that none runs dry while others still
+ * have work.
+ */
+struct _CSCoinScheduler
+{
+    guint64     next_position;
+    guint64     n_positions;
+    gint        done;
+    CSCoinTeam *team;
+};
+
+typedef struct _CSCoinSchedulerChunk CSCoinSchedulerChunk;
+
+/* per-worker, its length adapts to how long the previous chunk took */
+struct _CSCoinSchedulerChunk
+{
+    guint64 start;
+    guint64 length;
+    guint   granularity;
+    gint64  claimed_at;
+};
+
+void     cscoin_scheduler_init       (CSCoinScheduler      *self,
+                                      guint64               n_positions,
+                                      CSCoinTeam           *team);
+void     cscoin_scheduler_chunk_init (CSCoinSchedulerChunk *chunk,
+                                      guint                 granularity);
+gboolean cscoin_scheduler_next_chunk (CSCoinScheduler      *self,
+                                      CSCoinSchedulerChunk *chunk);
+void     cscoin_scheduler_stop       (CSCoinScheduler      *self);
+gboolean cscoin_scheduler_is_done    (CSCoinScheduler      *self);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_SCHEDULER_H__ */
@@ -0,0 +1,660 @@
+#include "cscoin-sha256.h"
+
+#include <openssl/sha.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CSCOIN_SHA256_HAVE_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/* the nonce, the '0x80' marker and the 64-bit length must fit in one block */
+#define CSCOIN_SHA256_MAX_TAIL_LENGTH 55
+
+typedef void (*CSCoinSHA256CompressFunc) (guint32       state[8],
+                                          const guint8 *blocks,
+                                          gsize         n_blocks);
+
+typedef struct _CSCoinSHA256Backend CSCoinSHA256Backend;
+
+struct _CSCoinSHA256Backend
+{
+    const gchar              *name;
+    CSCoinSHA256CompressFunc  compress;
+};
+
+typedef void (*CSCoinSHA256SeedBatchFunc) (const CSCoinSHA256Midstate  *midstate,
+                                           const CSCoinSHA256TailBatch *tails,
+                                           guint                        n_lanes,
+                                           guint64                     *seeds);
+
+typedef struct _CSCoinSHA256SeedBackend CSCoinSHA256SeedBackend;
+
+struct _CSCoinSHA256SeedBackend
+{
+    const gchar               *name;
+    guint                      lanes;
+    CSCoinSHA256SeedBatchFunc  func;
+};
+
+static const guint32 H[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/*
+ * OpenSSL 3 deprecates its low-level digest calls, but the EVP interface
+ * has no way to compress blocks from a given state, and its assembly still
+ * outruns plain C on the CPUs that lack the SHA extensions.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+static void
+compress_openssl (guint32 state[8], const guint8 *blocks, gsize n_blocks)
+{
+    SHA256_CTX ctx;
+    gsize i;
+
+    memcpy (ctx.h, state, sizeof (ctx.h));
+
+    for (i = 0; i < n_blocks; i++)
+    {
+        SHA256_Transform (&ctx, blocks + i * CSCOIN_SHA256_BLOCK_LENGTH);
+    }
+
+    memcpy (state, ctx.h, sizeof (ctx.h));
+}
+#pragma GCC diagnostic pop
+
+/*
+ * The first eight bytes of the digest are the big-endian encoding of the
+ * first two state words, read back as a little-endian integer.
+ */
+static inline guint64
+seed_from_state (guint32 h0, guint32 h1)
+{
+    return (guint64) GUINT32_SWAP_LE_BE (h0) | ((guint64) GUINT32_SWAP_LE_BE (h1) << 32);
+}
+
+/* the midstate already covers the 64 bytes of the prefix */
+static void
+fill_tail_block (guint8 block[CSCOIN_SHA256_BLOCK_LENGTH], const gchar *nonce, gsize nonce_len)
+{
+    guint64 length = GUINT64_TO_BE ((CSCOIN_SHA256_BLOCK_LENGTH + nonce_len) * 8);
+
+    memset (block, 0, CSCOIN_SHA256_BLOCK_LENGTH);
+    memcpy (block, nonce, nonce_len);
+    block[nonce_len] = 0x80;
+    memcpy (block + 56, &length, sizeof (length));
+}
+
+#ifdef CSCOIN_SHA256_HAVE_X86
+
+static const guint32 K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * The SHA extensions keep the state as the ABEF and CDGH halves and run two
+ * rounds per 'sha256rnds2', so the schedule is computed four words at a time.
+ */
+__attribute__ ((target ("sha,sse4.1")))
+static void
+compress_shani (guint32 state[8], const guint8 *blocks, gsize n_blocks)
+{
+    const __m128i byteswap = _mm_set_epi64x (0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i abef, cdgh, abef_save, cdgh_save;
+    __m128i msg[4], w, k, tmp;
+    gsize i;
+    guint g;
+
+    tmp  = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) &state[0]), 0xB1);
+    cdgh = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) &state[4]), 0x1B);
+    abef = _mm_alignr_epi8 (tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16 (cdgh, tmp, 0xF0);
+
+    for (i = 0; i < n_blocks; i++, blocks += CSCOIN_SHA256_BLOCK_LENGTH)
+    {
+        abef_save = abef;
+        cdgh_save = cdgh;
+
+        #pragma GCC unroll 16
+        for (g = 0; g < 16; g++)
+        {
+            if (g < 4)
+            {
+                w = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (blocks + 16 * g)), byteswap);
+            }
+            else
+            {
+                w = _mm_sha256msg1_epu32 (msg[g & 3], msg[(g + 1) & 3]);
+                w = _mm_add_epi32 (w, _mm_alignr_epi8 (msg[(g + 3) & 3], msg[(g + 2) & 3], 4));
+                w = _mm_sha256msg2_epu32 (w, msg[(g + 3) & 3]);
+            }
+
+            msg[g & 3] = w;
+
+            k    = _mm_add_epi32 (w, _mm_loadu_si128 ((const __m128i *) &K[4 * g]));
+            cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, k);
+            abef = _mm_sha256rnds2_epu32 (abef, cdgh, _mm_shuffle_epi32 (k, 0x0E));
+        }
+
+        abef = _mm_add_epi32 (abef, abef_save);
+        cdgh = _mm_add_epi32 (cdgh, cdgh_save);
+    }
+
+    tmp  = _mm_shuffle_epi32 (abef, 0x1B);
+    cdgh = _mm_shuffle_epi32 (cdgh, 0xB1);
+    _mm_storeu_si128 ((__m128i *) &state[0], _mm_blend_epi16 (tmp, cdgh, 0xF0));
+    _mm_storeu_si128 ((__m128i *) &state[4], _mm_alignr_epi8 (cdgh, tmp, 8));
+}
+
+static gboolean
+cpu_supports_shani (void)
+{
+    guint eax, ebx, ecx, edx;
+
+    if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1))
+    {
+        return FALSE;
+    }
+
+    if (!__get_cpuid_count (7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return FALSE;
+    }
+
+    return (ebx & bit_SHA) != 0;
+}
+
+#endif /* CSCOIN_SHA256_HAVE_X86 */
+
+static const CSCoinSHA256Backend
+BACKENDS[] =
+{
+#ifdef CSCOIN_SHA256_HAVE_X86
+    {"sha-ni",  compress_shani},
+#endif
+    {"openssl", compress_openssl}
+};
+
+static const CSCoinSHA256Backend *
+backend = NULL;
+
+static const CSCoinSHA256Backend *
+get_backend (void)
+{
+    if (g_once_init_enter (&backend))
+    {
+        const CSCoinSHA256Backend *selected_backend = &BACKENDS[G_N_ELEMENTS (BACKENDS) - 1];
+
+#ifdef CSCOIN_SHA256_HAVE_X86
+        if (cpu_supports_shani ())
+        {
+            selected_backend = &BACKENDS[0];
+        }
+#endif
+
+        g_once_init_leave (&backend, selected_backend);
+    }
+
+    return backend;
+}
+
+const gchar *
+cscoin_sha256_get_backend_name (void)
+{
+    return get_backend ()->name;
+}
+
+void
+cscoin_sha256_init (CSCoinSHA256 *self)
+{
+    memcpy (self->state, H, sizeof (self->state));
+    self->length     = 0;
+    self->buffer_len = 0;
+}
+
+void
+cscoin_sha256_update (CSCoinSHA256 *self, const void *data, gsize len)
+{
+    CSCoinSHA256CompressFunc compress = get_backend ()->compress;
+    const guint8 *bytes = data;
+    gsize n;
+
+    self->length += len;
+
+    if (self->buffer_len > 0)
+    {
+        n = MIN (CSCOIN_SHA256_BLOCK_LENGTH - self->buffer_len, len);
+
+        memcpy (self->buffer + self->buffer_len, bytes, n);
+        self->buffer_len += n;
+        bytes            += n;
+        len              -= n;
+
+        if (self->buffer_len < CSCOIN_SHA256_BLOCK_LENGTH)
+        {
+            return;
+        }
+
+        compress (self->state, self->buffer, 1);
+        self->buffer_len = 0;
+    }
+
+    if (len >= CSCOIN_SHA256_BLOCK_LENGTH)
+    {
+        n = len / CSCOIN_SHA256_BLOCK_LENGTH;
+
+        compress (self->state, bytes, n);
+        bytes += n * CSCOIN_SHA256_BLOCK_LENGTH;
+        len   -= n * CSCOIN_SHA256_BLOCK_LENGTH;
+    }
+
+    memcpy (self->buffer, bytes, len);
+    self->buffer_len = len;
+}
+
+void
+cscoin_sha256_final (CSCoinSHA256 *self, guint8 digest[CSCOIN_SHA256_DIGEST_LENGTH])
+{
+    CSCoinSHA256CompressFunc compress = get_backend ()->compress;
+    guint64 length = GUINT64_TO_BE (self->length * 8);
+    gint i;
+
+    self->buffer[self->buffer_len++] = 0x80;
+
+    /* the length does not fit after the marker, so it spills in a second block */
+    if (self->buffer_len > 56)
+    {
+        memset (self->buffer + self->buffer_len, 0, CSCOIN_SHA256_BLOCK_LENGTH - self->buffer_len);
+        compress (self->state, self->buffer, 1);
+        self->buffer_len = 0;
+    }
+
+    memset (self->buffer + self->buffer_len, 0, 56 - self->buffer_len);
+    memcpy (self->buffer + 56, &length, sizeof (length));
+    compress (self->state, self->buffer, 1);
+
+    for (i = 0; i < 8; i++)
+    {
+        guint32 word = GUINT32_TO_BE (self->state[i]);
+        memcpy (digest + 4 * i, &word, sizeof (word));
+    }
+}
+
+void
+cscoin_sha256_midstate_init (CSCoinSHA256Midstate *self, const gchar *prefix)
+{
+    cscoin_sha256_init (&self->ctx);
+    cscoin_sha256_update (&self->ctx, prefix, CSCOIN_SHA256_BLOCK_LENGTH);
+}
+
+/*
+ * Single-block path: each tail block is gathered back from its lane and
+ * compressed once from a copy of the midstate.
+ */
+static void
+seed_batch_generic (const CSCoinSHA256Midstate  *midstate,
+                    const CSCoinSHA256TailBatch *tails,
+                    guint                        n_lanes,
+                    guint64                     *seeds)
+{
+    CSCoinSHA256CompressFunc compress = get_backend ()->compress;
+    guint32 block[CSCOIN_SHA256_BLOCK_LENGTH / 4];
+    guint32 state[8];
+    guint lane, t;
+
+    for (lane = 0; lane < n_lanes; lane++)
+    {
+        for (t = 0; t < 16; t++)
+        {
+            block[t] = GUINT32_TO_BE (tails->words[CSCOIN_SHA256_MAX_LANES * t + lane]);
+        }
+
+        memcpy (state, midstate->ctx.state, sizeof (state));
+        compress (state, (const guint8 *) block, 1);
+
+        seeds[lane] = seed_from_state (state[0], state[1]);
+    }
+}
+
+#ifdef CSCOIN_SHA256_HAVE_X86
+#define ROTR_AVX2(x, n) _mm256_or_si256 (_mm256_srli_epi32 ((x), (n)), _mm256_slli_epi32 ((x), 32 - (n)))
+
+__attribute__ ((target ("avx2")))
+static void
+seed_batch_8_avx2 (const CSCoinSHA256Midstate *midstate,
+                   const guint32              *words,
+                   guint                       n_lanes,
+                   guint64                    *seeds)
+{
+    guint32 h0[8] __attribute__ ((aligned (32)));
+    guint32 h1[8] __attribute__ ((aligned (32)));
+    __m256i w[16];
+    __m256i a, b, c, d, e, f, g, h;
+    __m256i s0, s1, t1, t2;
+    guint t, lane;
+
+    for (t = 0; t < 16; t++)
+    {
+        w[t] = _mm256_load_si256 ((const __m256i *) &words[CSCOIN_SHA256_MAX_LANES * t]);
+    }
+
+    a = _mm256_set1_epi32 (midstate->ctx.state[0]);
+    b = _mm256_set1_epi32 (midstate->ctx.state[1]);
+    c = _mm256_set1_epi32 (midstate->ctx.state[2]);
+    d = _mm256_set1_epi32 (midstate->ctx.state[3]);
+    e = _mm256_set1_epi32 (midstate->ctx.state[4]);
+    f = _mm256_set1_epi32 (midstate->ctx.state[5]);
+    g = _mm256_set1_epi32 (midstate->ctx.state[6]);
+    h = _mm256_set1_epi32 (midstate->ctx.state[7]);
+
+    for (t = 0; t < 64; t++)
+    {
+        if (t >= 16)
+        {
+            __m256i w15 = w[(t - 15) & 15];
+            __m256i w2  = w[(t - 2) & 15];
+            s0 = _mm256_xor_si256 (_mm256_xor_si256 (ROTR_AVX2 (w15, 7), ROTR_AVX2 (w15, 18)), _mm256_srli_epi32 (w15, 3));
+            s1 = _mm256_xor_si256 (_mm256_xor_si256 (ROTR_AVX2 (w2, 17), ROTR_AVX2 (w2, 19)), _mm256_srli_epi32 (w2, 10));
+            w[t & 15] = _mm256_add_epi32 (_mm256_add_epi32 (w[t & 15], s0), _mm256_add_epi32 (w[(t - 7) & 15], s1));
+        }
+
+        s1 = _mm256_xor_si256 (_mm256_xor_si256 (ROTR_AVX2 (e, 6), ROTR_AVX2 (e, 11)), ROTR_AVX2 (e, 25));
+        t1 = _mm256_add_epi32 (_mm256_add_epi32 (h, s1),
+                               _mm256_add_epi32 (_mm256_xor_si256 (_mm256_and_si256 (e, f), _mm256_andnot_si256 (e, g)),
+                                                 _mm256_add_epi32 (_mm256_set1_epi32 (K[t]), w[t & 15])));
+        s0 = _mm256_xor_si256 (_mm256_xor_si256 (ROTR_AVX2 (a, 2), ROTR_AVX2 (a, 13)), ROTR_AVX2 (a, 22));
+        t2 = _mm256_add_epi32 (s0, _mm256_or_si256 (_mm256_and_si256 (a, b), _mm256_and_si256 (c, _mm256_or_si256 (a, b))));
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32 (d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32 (t1, t2);
+    }
+
+    _mm256_store_si256 ((__m256i *) h0, _mm256_add_epi32 (a, _mm256_set1_epi32 (midstate->ctx.state[0])));
+    _mm256_store_si256 ((__m256i *) h1, _mm256_add_epi32 (b, _mm256_set1_epi32 (midstate->ctx.state[1])));
+
+    for (lane = 0; lane < n_lanes; lane++)
+    {
+        seeds[lane] = seed_from_state (h0[lane], h1[lane]);
+    }
+}
+
+__attribute__ ((target ("avx2")))
+static void
+seed_batch_avx2 (const CSCoinSHA256Midstate  *midstate,
+                 const CSCoinSHA256TailBatch *tails,
+                 guint                        n_lanes,
+                 guint64                     *seeds)
+{
+    guint lane;
+
+    for (lane = 0; lane < n_lanes; lane += 8)
+    {
+        seed_batch_8_avx2 (midstate, tails->words + lane, MIN (8, n_lanes - lane), seeds + lane);
+    }
+}
+
+/* Ch and Maj as 'vpternlogd' truth tables */
+#define CSCOIN_SHA256_TERNLOG_CH  0xCA
+#define CSCOIN_SHA256_TERNLOG_MAJ 0xE8
+#define CSCOIN_SHA256_TERNLOG_XOR 0x96
+
+#define SIGMA_AVX512(x, r1, r2, r3) _mm512_ternarylogic_epi32 (_mm512_ror_epi32 ((x), (r1)), \
+                                                               _mm512_ror_epi32 ((x), (r2)), \
+                                                               _mm512_ror_epi32 ((x), (r3)), \
+                                                               CSCOIN_SHA256_TERNLOG_XOR)
+
+__attribute__ ((target ("avx512f")))
+static void
+seed_batch_16_avx512 (const CSCoinSHA256Midstate *midstate,
+                      const guint32              *words,
+                      guint                       n_lanes,
+                      guint64                    *seeds)
+{
+    guint32 h0[16] __attribute__ ((aligned (64)));
+    guint32 h1[16] __attribute__ ((aligned (64)));
+    __m512i w[16];
+    __m512i a, b, c, d, e, f, g, h;
+    __m512i s0, s1, t1, t2;
+    guint t, lane;
+
+    for (t = 0; t < 16; t++)
+    {
+        w[t] = _mm512_load_si512 ((const void *) &words[CSCOIN_SHA256_MAX_LANES * t]);
+    }
+
+    a = _mm512_set1_epi32 (midstate->ctx.state[0]);
+    b = _mm512_set1_epi32 (midstate->ctx.state[1]);
+    c = _mm512_set1_epi32 (midstate->ctx.state[2]);
+    d = _mm512_set1_epi32 (midstate->ctx.state[3]);
+    e = _mm512_set1_epi32 (midstate->ctx.state[4]);
+    f = _mm512_set1_epi32 (midstate->ctx.state[5]);
+    g = _mm512_set1_epi32 (midstate->ctx.state[6]);
+    h = _mm512_set1_epi32 (midstate->ctx.state[7]);
+
+    for (t = 0; t < 64; t++)
+    {
+        if (t >= 16)
+        {
+            __m512i w15 = w[(t - 15) & 15];
+            __m512i w2  = w[(t - 2) & 15];
+            s0 = _mm512_ternarylogic_epi32 (_mm512_ror_epi32 (w15, 7), _mm512_ror_epi32 (w15, 18), _mm512_srli_epi32 (w15, 3),
+                                            CSCOIN_SHA256_TERNLOG_XOR);
+            s1 = _mm512_ternarylogic_epi32 (_mm512_ror_epi32 (w2, 17), _mm512_ror_epi32 (w2, 19), _mm512_srli_epi32 (w2, 10),
+                                            CSCOIN_SHA256_TERNLOG_XOR);
+            w[t & 15] = _mm512_add_epi32 (_mm512_add_epi32 (w[t & 15], s0), _mm512_add_epi32 (w[(t - 7) & 15], s1));
+        }
+
+        t1 = _mm512_add_epi32 (_mm512_add_epi32 (h, SIGMA_AVX512 (e, 6, 11, 25)),
+                               _mm512_add_epi32 (_mm512_ternarylogic_epi32 (e, f, g, CSCOIN_SHA256_TERNLOG_CH),
+                                                 _mm512_add_epi32 (_mm512_set1_epi32 (K[t]), w[t & 15])));
+        t2 = _mm512_add_epi32 (SIGMA_AVX512 (a, 2, 13, 22), _mm512_ternarylogic_epi32 (a, b, c, CSCOIN_SHA256_TERNLOG_MAJ));
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm512_add_epi32 (d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm512_add_epi32 (t1, t2);
+    }
+
+    _mm512_store_si512 ((void *) h0, _mm512_add_epi32 (a, _mm512_set1_epi32 (midstate->ctx.state[0])));
+    _mm512_store_si512 ((void *) h1, _mm512_add_epi32 (b, _mm512_set1_epi32 (midstate->ctx.state[1])));
+
+    for (lane = 0; lane < n_lanes; lane++)
+    {
+        seeds[lane] = seed_from_state (h0[lane], h1[lane]);
+    }
+}
+
+__attribute__ ((target ("avx512f")))
+static void
+seed_batch_avx512 (const CSCoinSHA256Midstate  *midstate,
+                   const CSCoinSHA256TailBatch *tails,
+                   guint                        n_lanes,
+                   guint64                     *seeds)
+{
+    seed_batch_16_avx512 (midstate, tails->words, n_lanes, seeds);
+}
+
+#endif /* CSCOIN_SHA256_HAVE_X86 */
+
+static const CSCoinSHA256SeedBackend
+SEED_BACKENDS[] =
+{
+#ifdef CSCOIN_SHA256_HAVE_X86
+    {"avx512",       16, seed_batch_avx512},
+    {"avx2",         8,  seed_batch_avx2},
+#endif
+    {"single-block", 1,  seed_batch_generic}
+};
+
+static const CSCoinSHA256SeedBackend *
+seed_backend = NULL;
+
+/*
+ * Sixteen AVX-512 lanes outrun one SHA-NI core, which in turn beats eight
+ * AVX2 lanes.
+ */
+static const CSCoinSHA256SeedBackend *
+get_seed_backend (void)
+{
+    if (g_once_init_enter (&seed_backend))
+    {
+        const CSCoinSHA256SeedBackend *selected_backend = &SEED_BACKENDS[G_N_ELEMENTS (SEED_BACKENDS) - 1];
+
+#ifdef CSCOIN_SHA256_HAVE_X86
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx512f"))
+        {
+            selected_backend = &SEED_BACKENDS[0];
+        }
+        else if (__builtin_cpu_supports ("avx2") && get_backend ()->compress != compress_shani)
+        {
+            selected_backend = &SEED_BACKENDS[1];
+        }
+#endif
+
+        g_once_init_leave (&seed_backend, selected_backend);
+    }
+
+    return seed_backend;
+}
+
+const gchar *
+cscoin_sha256_get_seed_batch_backend_name (void)
+{
+    return get_seed_backend ()->name;
+}
+
+guint
+cscoin_sha256_get_seed_batch_lanes (void)
+{
+    return get_seed_backend ()->lanes;
+}
+
+/*
+ * Lay out the padded tail block of the nonce in 'lane', which must fit with
+ * its padding in a single block.
+ */
+void
+cscoin_sha256_tail_batch_set_nonce (CSCoinSHA256TailBatch *self,
+                                    guint                  lane,
+                                    const gchar           *nonce,
+                                    gsize                  nonce_len)
+{
+    guint8 block[CSCOIN_SHA256_BLOCK_LENGTH];
+    guint32 w;
+    guint t;
+
+    g_return_if_fail (lane < CSCOIN_SHA256_MAX_LANES);
+    g_return_if_fail (nonce_len <= CSCOIN_SHA256_MAX_TAIL_LENGTH);
+
+    fill_tail_block (block, nonce, nonce_len);
+
+    for (t = 0; t < 16; t++)
+    {
+        memcpy (&w, block + 4 * t, sizeof (w));
+        self->words[CSCOIN_SHA256_MAX_LANES * t + lane] = GUINT32_FROM_BE (w);
+    }
+}
+
+/*
+ * Copy bytes 'from' to 'to' of a nonce that only changed there, and whose
+ * length is the one of the nonce already laid out in 'lane'.
+ */
+void
+cscoin_sha256_tail_batch_patch_nonce (CSCoinSHA256TailBatch *self,
+                                      guint                  lane,
+                                      const gchar           *nonce,
+                                      gsize                  from,
+                                      gsize                  to)
+{
+    guint32 *word;
+    guint shift;
+    gsize i;
+
+    for (i = from; i < to; i++)
+    {
+        word   = &self->words[CSCOIN_SHA256_MAX_LANES * (i / 4) + lane];
+        shift  = 8 * (3 - i % 4);
+        *word  = (*word & ~(0xffu << shift)) | ((guint32) (guint8) nonce[i] << shift);
+    }
+}
+
+/*
+ * Compute the MT64 seed of the first 'n_lanes' tail blocks, that is the
+ * first 8 bytes of SHA-256 (prefix + nonce) read as a little-endian integer.
+ */
+void
+cscoin_sha256_midstate_seed_tail_batch (const CSCoinSHA256Midstate  *self,
+                                        const CSCoinSHA256TailBatch *tails,
+                                        guint                        n_lanes,
+                                        guint64                     *seeds)
+{
+    g_return_if_fail (n_lanes <= CSCOIN_SHA256_MAX_LANES);
+
+    get_seed_backend ()->func (self, tails, n_lanes, seeds);
+}
+
+void
+cscoin_sha256_midstate_seed_batch (const CSCoinSHA256Midstate *self,
+                                   const gchar * const        *nonces,
+                                   guint                       n_nonces,
+                                   guint64                    *seeds)
+{
+    CSCoinSHA256TailBatch tails = {{0}};
+    gsize nonce_lens[CSCOIN_SHA256_MAX_LANES];
+    guint i, lane, n_lanes;
+
+    for (i = 0; i < n_nonces; i += n_lanes)
+    {
+        n_lanes = MIN (CSCOIN_SHA256_MAX_LANES, n_nonces - i);
+
+        for (lane = 0; lane < n_lanes; lane++)
+        {
+            nonce_lens[lane] = strlen (nonces[i + lane]);
+
+            if (G_LIKELY (nonce_lens[lane] <= CSCOIN_SHA256_MAX_TAIL_LENGTH))
+            {
+                cscoin_sha256_tail_batch_set_nonce (&tails, lane, nonces[i + lane], nonce_lens[lane]);
+            }
+        }
+
+        get_seed_backend ()->func (self, &tails, n_lanes, seeds + i);
+
+        /* a nonce too long for the tail block is hashed on its own */
+        for (lane = 0; lane < n_lanes; lane++)
+        {
+            if (G_UNLIKELY (nonce_lens[lane] > CSCOIN_SHA256_MAX_TAIL_LENGTH))
+            {
+                CSCoinSHA256 ctx = self->ctx;
+                guint8 digest[CSCOIN_SHA256_DIGEST_LENGTH];
+
+                cscoin_sha256_update (&ctx, nonces[i + lane], nonce_lens[lane]);
+                cscoin_sha256_final (&ctx, digest);
+
+                seeds[i + lane] = seed_from_state (ctx.state[0], ctx.state[1]);
+            }
+        }
+    }
+}
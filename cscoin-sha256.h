@@ -0,0 +1,72 @@
+#ifndef __CSCOIN_SHA256_H__
+#define __CSCOIN_SHA256_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define CSCOIN_SHA256_BLOCK_LENGTH  64
+#define CSCOIN_SHA256_DIGEST_LENGTH 32
+
+/* largest batch a single seed kernel invocation can hash */
+#define CSCOIN_SHA256_MAX_LANES 16
+
+typedef struct _CSCoinSHA256 CSCoinSHA256;
+
+struct _CSCoinSHA256
+{
+    guint32 state[8];
+    guint64 length;
+    guint8  buffer[CSCOIN_SHA256_BLOCK_LENGTH];
+    gsize   buffer_len;
+};
+
+typedef struct _CSCoinSHA256Midstate CSCoinSHA256Midstate;
+
+struct _CSCoinSHA256Midstate
+{
+    CSCoinSHA256 ctx;
+};
+
+typedef struct _CSCoinSHA256TailBatch CSCoinSHA256TailBatch;
+
+/* word 't' of the tail block in lane 'l' is at 't * CSCOIN_SHA256_MAX_LANES + l' */
+struct _CSCoinSHA256TailBatch
+{
+    guint32 words[16 * CSCOIN_SHA256_MAX_LANES] __attribute__ ((aligned (64)));
+};
+
+const gchar * cscoin_sha256_get_backend_name            (void);
+void          cscoin_sha256_init                        (CSCoinSHA256 *self);
+void          cscoin_sha256_update                      (CSCoinSHA256 *self,
+                                                         const void   *data,
+                                                         gsize         len);
+void          cscoin_sha256_final                       (CSCoinSHA256 *self,
+                                                         guint8        digest[CSCOIN_SHA256_DIGEST_LENGTH]);
+
+const gchar * cscoin_sha256_get_seed_batch_backend_name (void);
+guint         cscoin_sha256_get_seed_batch_lanes        (void);
+void          cscoin_sha256_midstate_init               (CSCoinSHA256Midstate       *self,
+                                                         const gchar                *prefix);
+void          cscoin_sha256_midstate_seed_batch         (const CSCoinSHA256Midstate *self,
+                                                         const gchar * const        *nonces,
+                                                         guint                       n_nonces,
+                                                         guint64                    *seeds);
+
+void          cscoin_sha256_tail_batch_set_nonce        (CSCoinSHA256TailBatch       *self,
+                                                         guint                        lane,
+                                                         const gchar                 *nonce,
+                                                         gsize                        nonce_len);
+void          cscoin_sha256_tail_batch_patch_nonce      (CSCoinSHA256TailBatch       *self,
+                                                         guint                        lane,
+                                                         const gchar                 *nonce,
+                                                         gsize                        from,
+                                                         gsize                        to);
+void          cscoin_sha256_midstate_seed_tail_batch    (const CSCoinSHA256Midstate  *self,
+                                                         const CSCoinSHA256TailBatch *tails,
+                                                         guint                        n_lanes,
+                                                         guint64                     *seeds);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_SHA256_H__ */
@@ -1,252 +1,534 @@
 #include "cscoin-solver.h"
+#include "cscoin-arena.h"
+#include "cscoin-format.h"
+#include "cscoin-grid.h"
 #include "cscoin-mt64.h"
+#include "cscoin-nonce.h"
+#include "cscoin-scheduler.h"
+#include "cscoin-sha256.h"
+#include "cscoin-sort.h"
+#include "cscoin-team.h"
+#include "cscoin-telemetry.h"
 
-#include <omp.h>
-#include <openssl/sha.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include <astar.h>
+/* every grid walked by the shortest path solver since the process started */
+static CSCoinGridStatistics grid_statistics = {0};
+G_LOCK_DEFINE_STATIC (grid_statistics);
 
-static gint
-guint64cmp_asc (const void *a, const void *b)
+/* the memory all the workers of a challenge may take together, 0 if unbounded */
+static gsize memory_budget = 0;
+
+/* a warm-up maps this much of each arena, which covers all but the largest
+ * grids and stays quick enough not to hold up the next challenge */
+#define CSCOIN_SOLVER_PREFAULT_SIZE (16 * 1024 * 1024)
+
+typedef struct _CSCoinSolverWorker CSCoinSolverWorker;
+
+/* per-member state that outlives a single nonce attempt, carved from 'arena' */
+struct _CSCoinSolverWorker
 {
-    return *(guint64*) a < *(guint64*) b ? -1 : 1;
-}
+    CSCoinArena       arena;
+    CSCoinMT64        mt64;
+    CSCoinMT64xN      mt64xn;
+    const CSCoinSort *sort;
+    guint64          *sort_scratch;
+    gchar            *digits;
+    CSCoinGrid        grid;
+    CSCoinTelemetry   telemetry;
+    guint             n_batches;
+    gboolean          sampling;
+};
+
+/*
+ * The team and its workers, one per member, outlive the challenges: the
+ * next one starts on memory that is already mapped, or that a warm-up
+ * mapped ahead of it. They are started on first use and stopped when the
+ * placement or the number of workers changes. The midstate prepared for
+ * the next challenge and the hex digest of the last solution are kept
+ * alongside, all under 'workers'.
+ */
+static CSCoinPlacement placement = CSCOIN_PLACEMENT_ALL_THREADS;
+static guint max_workers = 0;
+static CSCoinTeam *solver_team = NULL;
+static CSCoinSolverWorker **solver_workers = NULL;
+static gchar prepared_last_solution_hash[2 * CSCOIN_SHA256_DIGEST_LENGTH + 1] = "";
+static CSCoinSHA256Midstate prepared_midstate;
+static gchar solution_hash[2 * CSCOIN_SHA256_DIGEST_LENGTH + 1] = "";
+G_LOCK_DEFINE_STATIC (workers);
+
+/* the size of the team, or 0 while there is none, kept apart so that it can
+ * be read without waiting for 'workers' */
+static gint n_workers = 0;
+
+/*
+ * The counters of the workers of the team, which their owners update
+ * atomically without locking and readers sum under 'telemetry' rather than
+ * 'workers', so that they can while a challenge is being solved. Those
+ * of the teams that were stopped are folded into 'retired_telemetry'.
+ */
+static CSCoinTelemetry **worker_telemetry = NULL;
+static guint n_worker_telemetry = 0;
+static CSCoinTelemetry retired_telemetry = {0};
+G_LOCK_DEFINE_STATIC (telemetry);
+
+/*
+ * Challenges that consume a known count of MT64 outputs get them pre-drawn
+ * in 'numbers', and the others draw from 'worker->mt64' on their own.
+ */
+typedef gboolean (*CSCoinChallengeSolverFunc) (CSCoinSolverWorker        *worker,
+                                               guint64                   *numbers,
+                                               CSCoinSHA256              *checksum,
+                                               CSCoinChallengeParameters *parameters);
+
+typedef struct _CSCoinSolverJob CSCoinSolverJob;
+
+/* a challenge as the members of the team see it, either solved or prepared for */
+struct _CSCoinSolverJob
+{
+    CSCoinChallengeType         challenge_type;
+    CSCoinChallengeParameters  *parameters;
+    CSCoinNonceStrategy         nonce_strategy;
+    CSCoinChallengeSolverFunc   solver_func;
+    gint                        nb_numbers;
+    CSCoinSort                  sort;
+    gsize                       arena_size;
+    gsize                       arena_limit;
+    guint16                     hash_prefix_num;
+    CSCoinSHA256Midstate        midstate;
+    CSCoinScheduler             scheduler;
+    gchar                      *nonce;
+    gint                        out_of_memory;
+};
 
-static gint
-guint64cmp_desc (const void *a, const void *b)
+/* the start of a stage, only read on the batches that are sampled */
+static inline guint64
+mark (CSCoinSolverWorker *worker)
 {
-    return *(guint64*) a > *(guint64*) b ? -1 : 1;
+    return worker->sampling ? cscoin_telemetry_get_cycles () : 0;
 }
 
-typedef gboolean (*CSCoinChallengeSolverFunc) (CSCoinMT64                *mt64,
-                                               SHA256_CTX                *checksum,
-                                               CSCoinChallengeParameters *parameters);
+/* charge the time since 'since' to 'stage' and start the next one */
+static inline guint64
+lap (CSCoinSolverWorker *worker, CSCoinTelemetryStage stage, guint64 since)
+{
+    guint64 now;
 
+    if (!worker->sampling)
+    {
+        return 0;
+    }
+
+    now = cscoin_telemetry_get_cycles ();
+    cscoin_telemetry_count (&worker->telemetry.stage_cycles[stage], now - since);
+
+    return now;
+}
+
+/* the sort kernel and its order are picked once per challenge, so both list
+ * challenges share this solver */
 static gboolean
-solve_sorted_list_challenge (CSCoinMT64 *mt64,
-                             SHA256_CTX *checksum,
+solve_sorted_list_challenge (CSCoinSolverWorker *worker,
+                             guint64 *numbers,
+                             CSCoinSHA256 *checksum,
                              CSCoinChallengeParameters *parameters)
 {
-    gint i;
     gint nb_elements = parameters->sorted_list.nb_elements;
-    guint64 numbers[nb_elements];
+    gsize digits_len;
+    guint64 stamp = mark (worker);
 
-    for (i = 0; i < nb_elements; i++)
-    {
-        numbers[i] = cscoin_mt64_next_uint64 (mt64);
-    }
+    cscoin_sort_uint64 (worker->sort, numbers, worker->sort_scratch);
+    stamp = lap (worker, CSCOIN_TELEMETRY_STAGE_SORT, stamp);
 
-    qsort (numbers, nb_elements, sizeof (guint64), guint64cmp_asc);
+    digits_len = cscoin_format_uint64_array (numbers, nb_elements, worker->digits);
+    stamp = lap (worker, CSCOIN_TELEMETRY_STAGE_FORMAT, stamp);
 
-    gchar number_str[32];
-    for (i = 0; i < nb_elements; i++)
-    {
-        g_snprintf (number_str, 32, "%lu", numbers[i]);
-        SHA256_Update (checksum, number_str, strlen (number_str));
-    }
+    cscoin_sha256_update (checksum, worker->digits, digits_len);
+    lap (worker, CSCOIN_TELEMETRY_STAGE_CHECKSUM, stamp);
 
     return TRUE;
 }
 
 static gboolean
-solve_reverse_sorted_list_challenge (CSCoinMT64                *mt64,
-                                     SHA256_CTX                *checksum,
-                                     CSCoinChallengeParameters *parameters)
+solve_shortest_path_challenge (CSCoinSolverWorker *worker,
+                               guint64 *numbers,
+                               CSCoinSHA256 *checksum,
+                               CSCoinChallengeParameters *parameters)
 {
-    gint i;
-    gint nb_elements = parameters->reverse_sorted_list.nb_elements;
-    guint64 numbers[nb_elements];
+    CSCoinGrid *grid = &worker->grid;
+    guint64 stamp = mark (worker);
+    gboolean solved;
+
+    cscoin_grid_generate (grid, &worker->mt64, parameters->shortest_path.nb_blockers);
+    stamp = lap (worker, CSCOIN_TELEMETRY_STAGE_GRID_GENERATION, stamp);
 
-    for (i = 0; i < nb_elements; i++)
+    solved = cscoin_grid_solve (grid);
+    stamp  = lap (worker, CSCOIN_TELEMETRY_STAGE_PATHFINDING, stamp);
+
+    if (!solved)
     {
-        numbers[i] = cscoin_mt64_next_uint64 (mt64);
+        return FALSE;
     }
 
-    qsort (numbers, nb_elements, sizeof (guint64), guint64cmp_desc);
+    /* the coordinates of every tile from the entry to the exit, all at once */
+    cscoin_sha256_update (checksum, grid->path_digits, grid->path_digits_length);
+    lap (worker, CSCOIN_TELEMETRY_STAGE_CHECKSUM, stamp);
+
+    return TRUE;
+}
 
-    gchar number_str[32];
-    for (i = 0; i < nb_elements; i++)
+/*
+ * The counts sent by the authority size the working memory of every
+ * worker, so they are checked before anything is sized from them.
+ */
+static gboolean
+check_parameters (CSCoinChallengeType         challenge_type,
+                  CSCoinChallengeParameters  *parameters,
+                  GError                    **error)
+{
+    switch (challenge_type)
     {
-        g_snprintf (number_str, 32, "%lu", numbers[i]);
-        SHA256_Update (checksum, number_str, strlen (number_str));
+        case CSCOIN_CHALLENGE_TYPE_SORTED_LIST:
+        case CSCOIN_CHALLENGE_TYPE_REVERSE_SORTED_LIST:
+            /* both list challenges lay their parameters out alike */
+            if (parameters->sorted_list.nb_elements < 0)
+            {
+                g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                             "The list cannot hold %d elements.",
+                             parameters->sorted_list.nb_elements);
+                return FALSE;
+            }
+            if (parameters->sorted_list.nb_elements > CSCOIN_SORT_MAX_NUMBERS)
+            {
+                g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                             "The list of %d elements is longer than the longest supported list of %d.",
+                             parameters->sorted_list.nb_elements, CSCOIN_SORT_MAX_NUMBERS);
+                return FALSE;
+            }
+            break;
+        case CSCOIN_CHALLENGE_TYPE_SHORTEST_PATH:
+            /* smaller grids leave less than two tiles inside the borders */
+            if (parameters->shortest_path.grid_size < 4)
+            {
+                g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                             "The grid size %d is too small to hold the start and end tiles.",
+                             parameters->shortest_path.grid_size);
+                return FALSE;
+            }
+            if (parameters->shortest_path.grid_size > CSCOIN_GRID_MAX_SIZE)
+            {
+                g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                             "The grid size %d is larger than the largest supported size of %d.",
+                             parameters->shortest_path.grid_size, CSCOIN_GRID_MAX_SIZE);
+                return FALSE;
+            }
+            /* the authority has not specified how these variants are drawn
+             * or walked, so the grid only searches unit moves along the rows
+             * and the columns */
+            if (parameters->shortest_path.movement != CSCOIN_GRID_MOVEMENT_CARDINAL ||
+                parameters->shortest_path.move_cost != 0 ||
+                parameters->shortest_path.diagonal_cost != 0 ||
+                parameters->shortest_path.max_tile_cost != 0)
+            {
+                g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                             "Grids that move in eight ways or weigh their moves or tiles are not supported until the authority specifies them.");
+                return FALSE;
+            }
+            break;
+        default:
+            break;
     }
 
     return TRUE;
 }
 
-typedef enum _CSCoinShortestPathTileType CSCoinShortestPathTileType;
-
-enum _CSCoinShortestPathTileType
+/* pick the solver of 'challenge_type' and size the arena of each worker */
+static gboolean
+setup_challenge (CSCoinChallengeType         challenge_type,
+                 CSCoinChallengeParameters  *parameters,
+                 CSCoinChallengeSolverFunc  *solver_func,
+                 gint                       *nb_numbers,
+                 CSCoinSort                 *sort,
+                 gsize                      *arena_size,
+                 GError                    **error)
 {
-    BLANK   = 0,
-    START   = 1,
-    END     = 2,
-    BLOCKER = 3
-};
+    gsize digits_size, numbers_size;
 
-typedef struct _CSCoinShortestPathGrid CSCoinShortestPathGrid;
+    switch (challenge_type)
+    {
+        case CSCOIN_CHALLENGE_TYPE_SORTED_LIST:
+            *solver_func = solve_sorted_list_challenge;
+            *nb_numbers  = parameters->sorted_list.nb_elements;
+            cscoin_sort_init (sort, *nb_numbers, FALSE);
+            break;
+        case CSCOIN_CHALLENGE_TYPE_REVERSE_SORTED_LIST:
+            *solver_func = solve_sorted_list_challenge;
+            *nb_numbers  = parameters->reverse_sorted_list.nb_elements;
+            cscoin_sort_init (sort, *nb_numbers, TRUE);
+            break;
+        case CSCOIN_CHALLENGE_TYPE_SHORTEST_PATH:
+            *solver_func = solve_shortest_path_challenge;
+            break;
+        default:
+            g_return_val_if_reached (FALSE);
+    }
 
-struct _CSCoinShortestPathGrid
-{
-    CSCoinShortestPathTileType *tiles;
-    gint                        size;
-};
+    /* the digits of a list and the numbers of a whole batch of them */
+    if (!g_size_checked_mul (&digits_size, *nb_numbers, CSCOIN_FORMAT_UINT64_MAX_LENGTH) ||
+        !g_size_checked_mul (&numbers_size, *nb_numbers, CSCOIN_SHA256_MAX_LANES * sizeof (guint64)))
+    {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                     "A list of %d elements is too large to be held.",
+                     *nb_numbers);
+        return FALSE;
+    }
 
-static guint8
-get_grid_cost (const guint32 x, const guint32 y, void* user_data)
+    *arena_size = CSCOIN_ARENA_ALIGN (sort->scratch_length * sizeof (guint64)) +
+                  CSCOIN_ARENA_ALIGN (digits_size + 1) +
+                  CSCOIN_ARENA_ALIGN (numbers_size);
+
+    if (challenge_type == CSCOIN_CHALLENGE_TYPE_SHORTEST_PATH)
+    {
+        *arena_size += cscoin_grid_get_arena_size (parameters->shortest_path.grid_size);
+    }
+
+    return TRUE;
+}
+
+/* the share of the budget each worker may grow its arena to, or 0 if
+ * there is no budget */
+static gsize
+get_arena_limit (CSCoinTeam *team)
 {
-    CSCoinShortestPathGrid *grid = user_data;
-    return grid->tiles[y * grid->size + x] == BLOCKER ? COST_BLOCKED : 1;
+    return memory_budget > 0 ? memory_budget / cscoin_team_get_n_threads (team) : 0;
 }
 
+/* each worker takes its whole arena up front, and only the searches that
+ * outgrow it take more, up to the limit above */
 static gboolean
-solve_shortest_path_challenge (CSCoinMT64 *mt64,
-                               SHA256_CTX *checksum,
-                               CSCoinChallengeParameters *parameters)
+check_memory_budget (CSCoinTeam *team, gsize arena_size, GError **error)
 {
-    gint grid_size   = parameters->shortest_path.grid_size;
-    gint nb_blockers = parameters->shortest_path.nb_blockers;
-    CSCoinShortestPathTileType grid[grid_size][grid_size];
-    guint64 x0, y0, x1, y1;
-    guint64 x, y;
-    gint i, j;
-
-    // initialize with blanks which is '0'
-    memset (grid, BLANK, sizeof (grid));
+    guint n_workers = cscoin_team_get_n_threads (team);
 
-    // X : COL Y : ROW
-    // grid[y][x]
-    // Borders
-    for (i = 0; i < grid_size; i++)
+    if (memory_budget > 0 && arena_size > get_arena_limit (team))
     {
-        grid[0][i]             = BLOCKER;
-        grid[grid_size - 1][i] = BLOCKER;
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                     "The %u workers would take %" G_GSIZE_FORMAT " bytes each, over the memory budget of %" G_GSIZE_FORMAT " bytes.",
+                     n_workers, arena_size, memory_budget);
+        return FALSE;
     }
 
-    for (j = 1; j < grid_size - 1; j++)
-    {
-        grid[j][0]             = BLOCKER;
-        grid[j][grid_size - 1] = BLOCKER;
-    }
+    return TRUE;
+}
 
-    // Start
-    for(;;)
+/* the team, started the first time; must be called under 'workers' */
+static CSCoinTeam *
+get_team (void)
+{
+    if (solver_team == NULL)
     {
-        y0 = cscoin_mt64_next_uint64 (mt64) % grid_size;
-        x0 = cscoin_mt64_next_uint64 (mt64) % grid_size;
+        solver_team    = cscoin_team_new (placement, max_workers);
+        solver_workers = g_new0 (CSCoinSolverWorker *, cscoin_team_get_n_threads (solver_team));
 
-        if (grid[y0][x0] == BLANK)
-        {
-            grid[y0][x0] = START;
-            break;
-        }
+        g_atomic_int_set (&n_workers, cscoin_team_get_n_threads (solver_team));
+
+        G_LOCK (telemetry);
+        n_worker_telemetry = cscoin_team_get_n_threads (solver_team);
+        worker_telemetry   = g_new0 (CSCoinTelemetry *, n_worker_telemetry);
+        G_UNLOCK (telemetry);
     }
 
-    // End
-    for(;;)
+    return solver_team;
+}
+
+/*
+ * The worker of the member 'index', which it allocates itself the first
+ * time, so that the pages first touched end up on the node of its CPU.
+ */
+static CSCoinSolverWorker *
+get_worker (guint index)
+{
+    if (solver_workers[index] == NULL)
     {
-        y1 = cscoin_mt64_next_uint64 (mt64) % grid_size;
-        x1 = cscoin_mt64_next_uint64 (mt64) % grid_size;
+        solver_workers[index] = g_new0 (CSCoinSolverWorker, 1);
+        cscoin_mt64_init (&solver_workers[index]->mt64);
 
-        if (grid[y1][x1] == BLANK)
-        {
-            grid[y1][x1] = END;
-            break;
-        }
+        G_LOCK (telemetry);
+        worker_telemetry[index] = &solver_workers[index]->telemetry;
+        G_UNLOCK (telemetry);
     }
 
-    // Blockers
-    for (i = 0; i < nb_blockers; i++)
+    return solver_workers[index];
+}
+
+/*
+ * The empty arena of 'worker', grown to at least 'size' bytes if it is
+ * smaller, or NULL if it could not be. It grows no further than 'limit'
+ * bytes in all afterwards.
+ */
+static CSCoinArena *
+acquire_worker_arena (CSCoinSolverWorker *worker, gsize size, gsize limit)
+{
+    CSCoinArena *arena = &worker->arena;
+
+    if (arena->data != NULL && arena->size >= size)
+    {
+        cscoin_arena_rewind (arena);
+    }
+    else
     {
-        y = cscoin_mt64_next_uint64 (mt64) % grid_size;
-        x = cscoin_mt64_next_uint64 (mt64) % grid_size;
+        cscoin_arena_clear (arena);
 
-        if (grid[y][x] == BLANK)
+        if (!cscoin_arena_init (arena, size))
         {
-            grid[y][x] = BLOCKER;
+            return NULL;
         }
     }
 
-    // Debugging
-    /*
-    g_printf("grid:\n");
-    for (j = 0; j < grid_size; j++)
+    cscoin_arena_set_limit (arena, limit);
+
+    return arena;
+}
+
+static void
+format_digest (const guint8 digest[CSCOIN_SHA256_DIGEST_LENGTH], gchar *hex)
+{
+    static const gchar HEX_DIGITS[] = "0123456789abcdef";
+    gint i;
+
+    for (i = 0; i < CSCOIN_SHA256_DIGEST_LENGTH; i++)
     {
-        for (i = 0; i < grid_size; i++)
-        {
-            g_printf("%u ", grid[j][i]);
-        }
-        g_printf("\n");
+        hex[2 * i]     = HEX_DIGITS[digest[i] >> 4];
+        hex[2 * i + 1] = HEX_DIGITS[digest[i] & 0xf];
     }
-    */
 
-    astar_t as;
+    hex[2 * CSCOIN_SHA256_DIGEST_LENGTH] = '\0';
+}
 
-    CSCoinShortestPathGrid user_data = { .tiles = (CSCoinShortestPathTileType*) grid, .size = grid_size };
-    astar_init (&as, grid_size, grid_size, get_grid_cost, &user_data, NULL);
+static void
+solve_worker (gpointer data, guint index)
+{
+    CSCoinSolverJob *job = data;
+    CSCoinSolverWorker *worker = get_worker (index);
+    CSCoinSHA256 checksum;
+    guint64 *numbers;
+    union {
+        guint8  digest[CSCOIN_SHA256_DIGEST_LENGTH];
+        guint16 prefix;
+    } checksum_digest;
+    CSCoinNonceSpace nonce_space;
+    CSCoinSchedulerChunk chunk;
+    gboolean found = FALSE;
+    guint64 seeds[CSCOIN_SHA256_MAX_LANES];
+    guint batch_size = MAX (cscoin_sha256_get_seed_batch_lanes (), CSCOIN_MT64XN_LANES);
+    guint lane, nb_lanes;
+    gint nb_numbers = job->nb_numbers;
+    guint64 stamp;
+
+    /* sized once, so that the nonce loop only allocates for the longest
+     * searches */
+    if (acquire_worker_arena (worker, job->arena_size, job->arena_limit) == NULL)
+    {
+        g_atomic_int_set (&job->out_of_memory, TRUE);
+        cscoin_scheduler_stop (&job->scheduler);
+        return;
+    }
+
+    worker->sort         = &job->sort;
+    worker->sort_scratch = cscoin_arena_new (&worker->arena, guint64, job->sort.scratch_length);
 
-    astar_set_origin (&as, 0, 0);
-    astar_set_movement_mode (&as, DIR_CARDINAL);
+    /* the digits are compressed straight from this buffer, a block at a
+     * time, and every arena allocation starts on a block */
+    worker->digits = cscoin_arena_new (&worker->arena, gchar, (gsize) nb_numbers * CSCOIN_FORMAT_UINT64_MAX_LENGTH + 1);
 
-    /*
-    astar_set_cost (&as, DIR_N, 10);
-    astar_set_cost (&as, DIR_W, 11);
-    astar_set_cost (&as, DIR_E, 12);
-    astar_set_cost (&as, DIR_S, 13);
-    */
+    numbers = cscoin_arena_new (&worker->arena, guint64, CSCOIN_SHA256_MAX_LANES * (gsize) nb_numbers);
 
-    // astar_set_steering_penalty (&as, 10);
-    // astar_set_heuristic_factor (&as, 10);
-    // astar_set_max_cost (100);
+    if (job->challenge_type == CSCOIN_CHALLENGE_TYPE_SHORTEST_PATH)
+    {
+        cscoin_grid_init (&worker->grid, job->parameters->shortest_path.grid_size, &worker->arena);
+    }
 
-    gint result = astar_run (&as, x0, y0, x1, y1);
+    cscoin_nonce_space_init (&nonce_space, job->nonce_strategy, batch_size);
+    cscoin_scheduler_chunk_init (&chunk, batch_size);
 
-    if (result == ASTAR_FOUND && astar_have_route (&as))
+    while (!found && cscoin_scheduler_next_chunk (&job->scheduler, &chunk))
     {
-        guint32 num_steps;
-        direction_t *directions;
-        gchar number_str[32];
+        cscoin_nonce_space_seek (&nonce_space, chunk.start, chunk.length);
 
-        num_steps = astar_get_directions (&as, &directions);
+        /* seeds are derived a whole batch of nonces at a time */
+        while (!found && (nb_lanes = cscoin_nonce_space_next_batch (&nonce_space)) > 0)
+        {
+            worker->sampling = ++worker->n_batches % CSCOIN_TELEMETRY_SAMPLE_PERIOD == 0;
 
-        x = x0;
-        y = y0;
+            cscoin_telemetry_count (&worker->telemetry.n_nonces, nb_lanes);
 
-        /* entry */
-        g_snprintf (number_str, 32, "%lu", y);
-        SHA256_Update (checksum, number_str, strlen (number_str));
-        g_snprintf (number_str, 32, "%lu", x);
-        SHA256_Update (checksum, number_str, strlen (number_str));
+            if (worker->sampling)
+            {
+                cscoin_telemetry_count (&worker->telemetry.n_sampled_nonces, nb_lanes);
+            }
 
-        /* hash all other coordinates including the exit */
-        for (i = 0; i < num_steps; i++)
-        {
-            x += astar_get_dx (&as, directions[i]);
-            y += astar_get_dy (&as, directions[i]);
-            // g_printf ("(%lu, %lu)", y, x);
-            g_snprintf (number_str, 32, "%lu", y);
-            SHA256_Update (checksum, number_str, strlen (number_str));
-            g_snprintf (number_str, 32, "%lu", x);
-            SHA256_Update (checksum, number_str, strlen (number_str));
-        }
+            stamp = mark (worker);
+
+            cscoin_sha256_midstate_seed_tail_batch (&job->midstate, &nonce_space.tails, nb_lanes, seeds);
+            stamp = lap (worker, CSCOIN_TELEMETRY_STAGE_SEED, stamp);
 
-        astar_free_directions (directions);
-        astar_clear (&as);
+            /* generators are seeded and advanced in lockstep, one per SIMD lane */
+            if (nb_numbers > 0)
+            {
+                for (lane = 0; lane < nb_lanes; lane += CSCOIN_MT64XN_LANES)
+                {
+                    cscoin_mt64xn_set_seeds (&worker->mt64xn, seeds + lane, MIN (CSCOIN_MT64XN_LANES, nb_lanes - lane));
+                    cscoin_mt64xn_fill_uint64 (&worker->mt64xn, numbers + lane * nb_numbers, nb_numbers);
+                }
 
-        // Debugging
-        //g_printf ("Route from (%d, %d) to (%d, %d). Result: %s (%d)\n",
-        //        as.x0, as.y0,
-        //        as.x1, as.y1,
-        //        as.str_result, result);
-        return TRUE;
+                lap (worker, CSCOIN_TELEMETRY_STAGE_MT64, stamp);
+            }
+
+            for (lane = 0; lane < nb_lanes; lane++)
+            {
+                if (nb_numbers == 0)
+                {
+                    cscoin_mt64_set_seed (&worker->mt64, seeds[lane]);
+                }
+
+                cscoin_sha256_init (&checksum);
+
+                if (job->solver_func (worker, numbers + lane * nb_numbers, &checksum, job->parameters))
+                {
+                    stamp = mark (worker);
+                    cscoin_sha256_final (&checksum, checksum_digest.digest);
+                    lap (worker, CSCOIN_TELEMETRY_STAGE_CHECKSUM, stamp);
+
+                    if (job->hash_prefix_num == GUINT16_FROM_LE (checksum_digest.prefix))
+                    {
+                        gchar *nonce = g_strdup (nonce_space.nonces[lane]);
+
+                        /* only the first solution is kept if several workers find one */
+                        if (g_atomic_pointer_compare_and_exchange (&job->nonce, NULL, nonce))
+                        {
+                            format_digest (checksum_digest.digest, solution_hash);
+                        }
+                        else
+                        {
+                            g_free (nonce);
+                        }
+
+                        cscoin_scheduler_stop (&job->scheduler);
+                        found = TRUE;
+                        break;
+                    }
+                }
+            }
+        }
     }
-    else
+
+    if (job->challenge_type == CSCOIN_CHALLENGE_TYPE_SHORTEST_PATH)
     {
-        astar_clear (&as);
-        return FALSE;
+        G_LOCK (grid_statistics);
+        cscoin_grid_statistics_add (&grid_statistics, &worker->grid.statistics);
+        G_UNLOCK (grid_statistics);
     }
 }
 
@@ -256,93 +538,322 @@ cscoin_solve_challenge (gint                        challenge_id,
                         const gchar                *last_solution_hash,
                         const gchar                *hash_prefix,
                         CSCoinChallengeParameters  *parameters,
+                        CSCoinNonceStrategy         nonce_strategy,
                         GCancellable               *cancellable,
                         GError                    **error)
 {
-    gboolean done = FALSE;
-    gchar *ret = NULL;
-    guint16 hash_prefix_num;
-    CSCoinChallengeSolverFunc solver_func;
+    CSCoinTeam *team;
+    CSCoinSolverJob job = {0};
 
-    hash_prefix_num = GUINT16_FROM_BE (strtol (hash_prefix, NULL, 16));
+    if (!check_parameters (challenge_type, parameters, error))
+    {
+        return NULL;
+    }
 
-    switch (challenge_type)
+    if (!setup_challenge (challenge_type, parameters, &job.solver_func, &job.nb_numbers, &job.sort, &job.arena_size, error))
     {
-        case CSCOIN_CHALLENGE_TYPE_SORTED_LIST:
-            solver_func = solve_sorted_list_challenge;
-            break;
-        case CSCOIN_CHALLENGE_TYPE_REVERSE_SORTED_LIST:
-            solver_func = solve_reverse_sorted_list_challenge;
-            break;
-        case CSCOIN_CHALLENGE_TYPE_SHORTEST_PATH:
-            solver_func = solve_shortest_path_challenge;
-            return NULL;
-            break;
-        default:
-            g_return_val_if_reached (NULL);
+        return NULL;
+    }
+
+    job.challenge_type  = challenge_type;
+    job.parameters      = parameters;
+    job.nonce_strategy  = nonce_strategy;
+    job.hash_prefix_num = GUINT16_FROM_BE (strtol (hash_prefix, NULL, 16));
+
+    G_LOCK (workers);
+
+    team = get_team ();
+
+    if (!check_memory_budget (team, job.arena_size, error))
+    {
+        G_UNLOCK (workers);
+        return NULL;
+    }
+
+    job.arena_limit = get_arena_limit (team);
+
+    /* the 64 bytes of 'last_solution_hash' fill exactly one SHA-256 block, so
+     * it is compressed once, unless a warm-up did already, and every nonce
+     * attempt resumes from a copy */
+    if (strcmp (last_solution_hash, prepared_last_solution_hash) == 0)
+    {
+        job.midstate = prepared_midstate;
+    }
+    else
+    {
+        cscoin_sha256_midstate_init (&job.midstate, last_solution_hash);
+    }
+
+    solution_hash[0] = '\0';
+
+    cscoin_scheduler_init (&job.scheduler, cscoin_nonce_strategy_get_n_positions (nonce_strategy), team);
+
+    cscoin_team_run (team, solve_worker, &job, cancellable);
+
+    if (job.out_of_memory)
+    {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                     "Could not allocate the %" G_GSIZE_FORMAT " bytes of a worker.",
+                     job.arena_size);
+        g_clear_pointer (&job.nonce, g_free);
     }
+    else if (g_cancellable_set_error_if_cancelled (cancellable, error))
+    {
+        g_clear_pointer (&job.nonce, g_free);
+    }
+
+    /* a solution that is not returned has no hash either */
+    if (job.nonce == NULL)
+    {
+        solution_hash[0] = '\0';
+    }
+
+    G_UNLOCK (workers);
+
+    return job.nonce;
+}
+
+static void
+prepare_worker (gpointer data, guint index)
+{
+    CSCoinSolverJob *job = data;
+    CSCoinArena *arena = acquire_worker_arena (get_worker (index), job->arena_size, job->arena_limit);
 
-    #pragma omp parallel
+    if (arena != NULL)
     {
-        SHA256_CTX checksum;
-        CSCoinMT64 mt64;
-        union {
-            guint8  digest[SHA256_DIGEST_LENGTH];
-            guint64 seed;
-            guint16 prefix;
-        } checksum_digest;
-        guint64 index;
-        guint64 nonce_state;
-        guint64 nonce;
-        gchar nonce_str[32];
+        cscoin_arena_prefault (arena, CSCOIN_SOLVER_PREFAULT_SIZE);
+    }
+}
 
-        cscoin_mt64_init (&mt64);
+/*
+ * Get the workers ready for a challenge that has yet to come: their arenas
+ * are sized for 'challenge_type' and 'parameters' and their first pages
+ * mapped, and the midstate of 'last_solution_hash' is kept in case it shows up.
+ * Challenges that could not be solved are not prepared for.
+ */
+void
+cscoin_prepare_challenge (const gchar                *last_solution_hash,
+                          CSCoinChallengeType         challenge_type,
+                          CSCoinChallengeParameters  *parameters)
+{
+    CSCoinTeam *team;
+    CSCoinSolverJob job = {0};
 
-        /* OpenMP partitionning */
-        guint64 index_from, index_to;
-        guint64 index_partition_size = G_MAXUINT64 / omp_get_num_threads ();
+    if (!check_parameters (challenge_type, parameters, NULL) ||
+        !setup_challenge (challenge_type, parameters, &job.solver_func, &job.nb_numbers, &job.sort, &job.arena_size, NULL))
+    {
+        return;
+    }
+
+    G_LOCK (workers);
 
-        index_from  = omp_get_thread_num () * index_partition_size;
-        index_to    = index_from + index_partition_size;
-        nonce_state = 15265499401763465969ULL % index_partition_size;
+    team = get_team ();
 
-        for (index = index_from; index < index_to; index++)
+    if (!check_memory_budget (team, job.arena_size, NULL))
+    {
+        G_UNLOCK (workers);
+        return;
+    }
+
+    job.arena_limit = get_arena_limit (team);
+
+    g_strlcpy (prepared_last_solution_hash, last_solution_hash, sizeof (prepared_last_solution_hash));
+    cscoin_sha256_midstate_init (&prepared_midstate, prepared_last_solution_hash);
+
+    /* this also catches the members that went to sleep since the last
+     * challenge, which then spin for a while before sleeping again */
+    cscoin_team_run (team, prepare_worker, &job, NULL);
+
+    G_UNLOCK (workers);
+}
+
+/* the hex digest of the last solution found, or NULL if the last challenge
+ * was not solved */
+gchar *
+cscoin_get_solution_hash (void)
+{
+    gchar *ret;
+
+    G_LOCK (workers);
+    ret = solution_hash[0] != '\0' ? g_strdup (solution_hash) : NULL;
+    G_UNLOCK (workers);
+
+    return ret;
+}
+
+void
+cscoin_get_grid_statistics (CSCoinGridStatistics *statistics)
+{
+    G_LOCK (grid_statistics);
+    *statistics = grid_statistics;
+    G_UNLOCK (grid_statistics);
+}
+
+/* everything the workers did since the process started */
+void
+cscoin_get_telemetry (CSCoinTelemetry *telemetry)
+{
+    guint i;
+
+    G_LOCK (telemetry);
+
+    *telemetry = retired_telemetry;
+
+    for (i = 0; i < n_worker_telemetry; i++)
+    {
+        if (worker_telemetry[i] != NULL)
         {
-            if (G_UNLIKELY (done || g_cancellable_is_cancelled (cancellable)))
-            {
-                break;
-            }
+            cscoin_telemetry_add (telemetry, worker_telemetry[i]);
+        }
+    }
 
-            nonce       = index_from + nonce_state;
-            nonce_state = (nonce_state + 15265499401763465969ULL) % index_partition_size;
+    G_UNLOCK (telemetry);
+}
 
-            g_snprintf (nonce_str, 32, "%lu", nonce);
+/*
+ * What the worker 'index' of the current team did since it was started,
+ * or FALSE if there is no such worker yet.
+ */
+gboolean
+cscoin_get_worker_telemetry (guint index, CSCoinTelemetry *telemetry)
+{
+    gboolean ret = FALSE;
 
-            SHA256_Init (&checksum);
-            SHA256_Update (&checksum, last_solution_hash, 64);
-            SHA256_Update (&checksum, nonce_str, strlen (nonce_str));
-            SHA256_Final (checksum_digest.digest, &checksum);
+    G_LOCK (telemetry);
 
-            cscoin_mt64_set_seed (&mt64, GUINT64_FROM_LE (checksum_digest.seed));
+    if (index < n_worker_telemetry && worker_telemetry[index] != NULL)
+    {
+        memset (telemetry, 0, sizeof (CSCoinTelemetry));
+        cscoin_telemetry_add (telemetry, worker_telemetry[index]);
+        ret = TRUE;
+    }
 
-            SHA256_Init (&checksum);
+    G_UNLOCK (telemetry);
 
-            if (solver_func (&mt64, &checksum, parameters))
-            {
-                SHA256_Final (checksum_digest.digest, &checksum);
+    return ret;
+}
 
-                if (hash_prefix_num == GUINT16_FROM_LE (checksum_digest.prefix))
-                {
-                    done = TRUE;
-                    ret = g_strdup (nonce_str);
-                }
-            }
+void
+cscoin_set_memory_budget (gsize budget)
+{
+    memory_budget = budget;
+}
+
+gsize
+cscoin_get_memory_budget (void)
+{
+    return memory_budget;
+}
+
+/*
+ * Stop the team, if any, along with the memory of its workers, so that the
+ * next challenge starts a new one cold. Must be called under 'workers'.
+ */
+static void
+stop_team (void)
+{
+    guint i;
+
+    if (solver_team == NULL)
+    {
+        return;
+    }
+
+    G_LOCK (telemetry);
+
+    for (i = 0; i < n_worker_telemetry; i++)
+    {
+        if (worker_telemetry[i] != NULL)
+        {
+            cscoin_telemetry_add (&retired_telemetry, worker_telemetry[i]);
         }
     }
 
-    if (g_cancellable_set_error_if_cancelled (cancellable, error))
+    g_clear_pointer (&worker_telemetry, g_free);
+    n_worker_telemetry = 0;
+
+    G_UNLOCK (telemetry);
+
+    for (i = 0; i < cscoin_team_get_n_threads (solver_team); i++)
     {
-        return NULL;
+        if (solver_workers[i] != NULL)
+        {
+            cscoin_arena_clear (&solver_workers[i]->arena);
+            g_free (solver_workers[i]);
+        }
+    }
+
+    g_atomic_int_set (&n_workers, 0);
+
+    g_clear_pointer (&solver_workers, g_free);
+    g_clear_pointer (&solver_team, cscoin_team_free);
+}
+
+/* place the workers as told by 'new_placement' from the next challenge on */
+void
+cscoin_set_placement (CSCoinPlacement new_placement)
+{
+    G_LOCK (workers);
+
+    if (new_placement != placement)
+    {
+        stop_team ();
+        placement = new_placement;
+    }
+
+    G_UNLOCK (workers);
+}
+
+CSCoinPlacement
+cscoin_get_placement (void)
+{
+    return placement;
+}
+
+/*
+ * Solve with no more than 'new_max_workers' workers from the next challenge
+ * on, the first ones of the placement, or as many as it has if 0.
+ */
+void
+cscoin_set_max_workers (guint new_max_workers)
+{
+    G_LOCK (workers);
+
+    if (new_max_workers != max_workers)
+    {
+        stop_team ();
+        max_workers = new_max_workers;
+    }
+
+    G_UNLOCK (workers);
+}
+
+guint
+cscoin_get_max_workers (void)
+{
+    return max_workers;
+}
+
+/*
+ * How many workers solve each challenge under the current placement. This
+ * never waits for a challenge: 'workers' is only taken to start a team when
+ * there is none, and whoever holds it instead starts one before solving.
+ */
+guint
+cscoin_get_n_workers (void)
+{
+    gint ret;
+
+    while ((ret = g_atomic_int_get (&n_workers)) == 0)
+    {
+        if (G_TRYLOCK (workers))
+        {
+            ret = cscoin_team_get_n_threads (get_team ());
+            G_UNLOCK (workers);
+            break;
+        }
+
+        g_thread_yield ();
     }
 
     return ret;
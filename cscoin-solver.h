@@ -6,13 +6,38 @@
 
 #include "cscoin-challenge-type.h"
 #include "cscoin-challenge-parameters.h"
+#include "cscoin-grid.h"
+#include "cscoin-nonce-strategy.h"
+#include "cscoin-placement.h"
+#include "cscoin-telemetry.h"
 
 gchar * cscoin_solve_challenge (gint                        challenge_id,
                                 CSCoinChallengeType         challenge_type,
                                 const gchar                *last_solution_hash,
                                 const gchar                *hash_prefix,
                                 CSCoinChallengeParameters  *parameters,
+                                CSCoinNonceStrategy         nonce_strategy,
                                 GCancellable               *cancellable,
                                 GError                    **error);
 
+void    cscoin_prepare_challenge (const gchar                *last_solution_hash,
+                                  CSCoinChallengeType         challenge_type,
+                                  CSCoinChallengeParameters  *parameters);
+gchar * cscoin_get_solution_hash (void);
+
+void     cscoin_get_grid_statistics  (CSCoinGridStatistics *statistics);
+void     cscoin_get_telemetry        (CSCoinTelemetry      *telemetry);
+gboolean cscoin_get_worker_telemetry (guint                 index,
+                                      CSCoinTelemetry      *telemetry);
+
+void    cscoin_set_memory_budget   (gsize                 budget);
+gsize   cscoin_get_memory_budget   (void);
+
+void            cscoin_set_placement (CSCoinPlacement placement);
+CSCoinPlacement cscoin_get_placement (void);
+guint           cscoin_get_n_workers (void);
+
+void            cscoin_set_max_workers (guint max_workers);
+guint           cscoin_get_max_workers (void);
+
 #endif /* __CSCOIN_SOLVER_H__ */
@@ -0,0 +1,366 @@
+#include "cscoin-sort.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CSCOIN_SORT_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#define CSCOIN_SORT_RADIX_BITS   8
+#define CSCOIN_SORT_RADIX_SIZE   (1 << CSCOIN_SORT_RADIX_BITS)
+#define CSCOIN_SORT_RADIX_PASSES (64 / CSCOIN_SORT_RADIX_BITS)
+
+/*
+ * Each element sinks down to its place while carrying the smaller value, so
+ * the inner loop compiles to conditional moves instead of a mispredicted
+ * early exit.
+ */
+static void
+sort_insertion (guint64 *numbers, gsize n_numbers, guint64 *scratch)
+{
+    guint64 x, y;
+    gsize i, j;
+
+    for (i = 1; i < n_numbers; i++)
+    {
+        x = numbers[i];
+
+        for (j = i; j > 0; j--)
+        {
+            y = numbers[j - 1];
+            numbers[j] = MAX (x, y);
+            x = MIN (x, y);
+        }
+
+        numbers[0] = x;
+    }
+}
+
+static void
+sort_radix (guint64 *numbers, gsize n_numbers, guint64 *scratch)
+{
+    gsize counts[CSCOIN_SORT_RADIX_PASSES][CSCOIN_SORT_RADIX_SIZE];
+    guint64 *src = numbers;
+    guint64 *dst = scratch;
+    guint64 *tmp;
+    gsize offset, count;
+    gsize i;
+    gint pass, digit;
+
+    memset (counts, 0, sizeof (counts));
+
+    /* every histogram is built in a single read of the keys */
+    for (i = 0; i < n_numbers; i++)
+    {
+        for (pass = 0; pass < CSCOIN_SORT_RADIX_PASSES; pass++)
+        {
+            counts[pass][(numbers[i] >> (pass * CSCOIN_SORT_RADIX_BITS)) & (CSCOIN_SORT_RADIX_SIZE - 1)]++;
+        }
+    }
+
+    for (pass = 0; pass < CSCOIN_SORT_RADIX_PASSES; pass++)
+    {
+        gint shift = pass * CSCOIN_SORT_RADIX_BITS;
+
+        /* all keys share this digit, so the pass would not move anything */
+        if (counts[pass][(src[0] >> shift) & (CSCOIN_SORT_RADIX_SIZE - 1)] == n_numbers)
+        {
+            continue;
+        }
+
+        for (digit = 0, offset = 0; digit < CSCOIN_SORT_RADIX_SIZE; digit++)
+        {
+            count                = counts[pass][digit];
+            counts[pass][digit]  = offset;
+            offset              += count;
+        }
+
+        for (i = 0; i < n_numbers; i++)
+        {
+            dst[counts[pass][(src[i] >> shift) & (CSCOIN_SORT_RADIX_SIZE - 1)]++] = src[i];
+        }
+
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != numbers)
+    {
+        memcpy (numbers, src, n_numbers * sizeof (guint64));
+    }
+}
+
+static gsize
+next_power_of_two (gsize n)
+{
+    gsize p = 1;
+
+    while (p < n)
+    {
+        p <<= 1;
+    }
+
+    return p;
+}
+
+/*
+ * One compare-exchange level of the bitonic network: element 'i' is paired
+ * with 'i ^ j' and the pair is ascending when bit 'k' of 'i' is clear.
+ */
+static void
+bitonic_level_scalar (guint64 *keys, gsize n_keys, gsize k, gsize j)
+{
+    guint64 lo, hi;
+    gsize i;
+
+    for (i = 0; i < n_keys; i++)
+    {
+        if (i & j)
+        {
+            continue;
+        }
+
+        lo = MIN (keys[i], keys[i | j]);
+        hi = MAX (keys[i], keys[i | j]);
+
+        keys[i]     = (i & k) ? hi : lo;
+        keys[i | j] = (i & k) ? lo : hi;
+    }
+}
+
+#ifdef CSCOIN_SORT_HAVE_X86
+
+/* AVX2 only compares signed 64-bit lanes, so the sign bit is flipped first */
+__attribute__ ((target ("avx2")))
+static inline __m256i
+cmpgt_epu64_avx2 (__m256i a, __m256i b)
+{
+    const __m256i sign = _mm256_set1_epi64x (G_MININT64);
+
+    return _mm256_cmpgt_epi64 (_mm256_xor_si256 (a, sign), _mm256_xor_si256 (b, sign));
+}
+
+__attribute__ ((target ("avx2")))
+static void
+bitonic_level_avx2 (guint64 *keys, gsize n_keys, gsize k, gsize j)
+{
+    __m256i a, b, gt;
+    gsize i;
+
+    if (j < 4)
+    {
+        bitonic_level_scalar (keys, n_keys, k, j);
+        return;
+    }
+
+    /* whole vectors pair up, and share the direction given by 'k > j' */
+    for (i = 0; i < n_keys; i += 4)
+    {
+        if (i & j)
+        {
+            continue;
+        }
+
+        a  = _mm256_loadu_si256 ((const __m256i *) &keys[i]);
+        b  = _mm256_loadu_si256 ((const __m256i *) &keys[i | j]);
+        gt = cmpgt_epu64_avx2 (a, b);
+
+        if (i & k)
+        {
+            gt = _mm256_xor_si256 (gt, _mm256_set1_epi64x (-1));
+        }
+
+        _mm256_storeu_si256 ((__m256i *) &keys[i],     _mm256_blendv_epi8 (a, b, gt));
+        _mm256_storeu_si256 ((__m256i *) &keys[i | j], _mm256_blendv_epi8 (b, a, gt));
+    }
+}
+
+__attribute__ ((target ("avx512f")))
+static void
+bitonic_level_avx512 (guint64 *keys, gsize n_keys, gsize k, gsize j)
+{
+    const __m512i lanes = _mm512_set_epi64 (7, 6, 5, 4, 3, 2, 1, 0);
+    __m512i a, b, indices;
+    __mmask8 take_max;
+    gsize i;
+
+    if (j >= 8)
+    {
+        for (i = 0; i < n_keys; i += 8)
+        {
+            if (i & j)
+            {
+                continue;
+            }
+
+            a = _mm512_loadu_si512 ((const void *) &keys[i]);
+            b = _mm512_loadu_si512 ((const void *) &keys[i | j]);
+
+            _mm512_storeu_si512 ((void *) &keys[i],     (i & k) ? _mm512_max_epu64 (a, b) : _mm512_min_epu64 (a, b));
+            _mm512_storeu_si512 ((void *) &keys[i | j], (i & k) ? _mm512_min_epu64 (a, b) : _mm512_max_epu64 (a, b));
+        }
+
+        return;
+    }
+
+    /*
+     * Pairs sit within a vector: each lane compares with its partner lane
+     * and keeps the maximum when it is the upper lane of an ascending pair
+     * or the lower lane of a descending one.
+     */
+    for (i = 0; i < n_keys; i += 8)
+    {
+        indices  = _mm512_add_epi64 (lanes, _mm512_set1_epi64 (i));
+        take_max = _mm512_test_epi64_mask (indices, _mm512_set1_epi64 (j)) ^
+                   _mm512_test_epi64_mask (indices, _mm512_set1_epi64 (k));
+
+        a = _mm512_loadu_si512 ((const void *) &keys[i]);
+        b = _mm512_permutexvar_epi64 (_mm512_xor_si512 (lanes, _mm512_set1_epi64 (j)), a);
+
+        _mm512_storeu_si512 ((void *) &keys[i], _mm512_mask_blend_epi64 (take_max, _mm512_min_epu64 (a, b), _mm512_max_epu64 (a, b)));
+    }
+}
+
+#endif /* CSCOIN_SORT_HAVE_X86 */
+
+typedef void (*CSCoinSortBitonicLevelFunc) (guint64 *keys, gsize n_keys, gsize k, gsize j);
+
+typedef struct _CSCoinSortBackend CSCoinSortBackend;
+
+/*
+ * Lists up to 'small_max' keys use the insertion sort, and lists up to
+ * 'medium_max' keys use the bitonic network. The thresholds were measured
+ * on random 64-bit keys: without SIMD, the network never beats the radix sort.
+ */
+struct _CSCoinSortBackend
+{
+    const gchar                *name;
+    CSCoinSortBitonicLevelFunc  bitonic_level;
+    gsize                       small_max;
+    gsize                       medium_max;
+};
+
+static const CSCoinSortBackend
+BACKENDS[] =
+{
+#ifdef CSCOIN_SORT_HAVE_X86
+    {"avx512", bitonic_level_avx512, 8,  16384},
+    {"avx2",   bitonic_level_avx2,   32, 128},
+#endif
+    {"scalar", bitonic_level_scalar, 32, 32}
+};
+
+static const CSCoinSortBackend *
+backend = NULL;
+
+static const CSCoinSortBackend *
+get_backend (void)
+{
+    if (g_once_init_enter (&backend))
+    {
+        const CSCoinSortBackend *selected_backend = &BACKENDS[G_N_ELEMENTS (BACKENDS) - 1];
+
+#ifdef CSCOIN_SORT_HAVE_X86
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx512f"))
+        {
+            selected_backend = &BACKENDS[0];
+        }
+        else if (__builtin_cpu_supports ("avx2"))
+        {
+            selected_backend = &BACKENDS[1];
+        }
+#endif
+
+        g_once_init_leave (&backend, selected_backend);
+    }
+
+    return backend;
+}
+
+/*
+ * The keys are padded with G_MAXUINT64 up to a power of two in 'scratch',
+ * where the network runs, and the padding sorts past the real keys.
+ */
+static void
+sort_bitonic (guint64 *numbers, gsize n_numbers, guint64 *scratch)
+{
+    CSCoinSortBitonicLevelFunc level = get_backend ()->bitonic_level;
+    gsize n_keys = next_power_of_two (n_numbers);
+    gsize i, j, k;
+
+    memcpy (scratch, numbers, n_numbers * sizeof (guint64));
+
+    for (i = n_numbers; i < n_keys; i++)
+    {
+        scratch[i] = G_MAXUINT64;
+    }
+
+    for (k = 2; k <= n_keys; k <<= 1)
+    {
+        for (j = k >> 1; j > 0; j >>= 1)
+        {
+            level (scratch, n_keys, k, j);
+        }
+    }
+
+    memcpy (numbers, scratch, n_numbers * sizeof (guint64));
+}
+
+void
+cscoin_sort_init (CSCoinSort *self, gsize n_numbers, gboolean descending)
+{
+    const CSCoinSortBackend *sort_backend = get_backend ();
+
+    self->n_numbers  = n_numbers;
+    self->descending = descending;
+
+    if (n_numbers <= sort_backend->small_max)
+    {
+        self->name           = "insertion";
+        self->func           = sort_insertion;
+        self->scratch_length = 0;
+    }
+    else if (n_numbers <= sort_backend->medium_max)
+    {
+        self->name           = "bitonic";
+        self->func           = sort_bitonic;
+        self->scratch_length = next_power_of_two (n_numbers);
+    }
+    else
+    {
+        self->name           = "radix";
+        self->func           = sort_radix;
+        self->scratch_length = n_numbers;
+    }
+}
+
+/*
+ * Sorting the complemented keys in ascending order yields the descending
+ * order of the original keys, so both orders share the same kernels.
+ */
+void
+cscoin_sort_uint64 (const CSCoinSort *self, guint64 *numbers, guint64 *scratch)
+{
+    gsize i;
+
+    if (self->descending)
+    {
+        for (i = 0; i < self->n_numbers; i++)
+        {
+            numbers[i] = ~numbers[i];
+        }
+    }
+
+    self->func (numbers, self->n_numbers, scratch);
+
+    if (self->descending)
+    {
+        for (i = 0; i < self->n_numbers; i++)
+        {
+            numbers[i] = ~numbers[i];
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef __CSCOIN_SORT_H__
+#define __CSCOIN_SORT_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* the longest list a challenge may ask for, which keeps every buffer sized
+ * from it well within a gsize */
+#define CSCOIN_SORT_MAX_NUMBERS (1 << 24)
+
+typedef void (*CSCoinSortFunc) (guint64 *numbers, gsize n_numbers, guint64 *scratch);
+
+typedef struct _CSCoinSort CSCoinSort;
+
+struct _CSCoinSort
+{
+    const gchar    *name;
+    CSCoinSortFunc  func;
+    gsize           n_numbers;
+    gsize           scratch_length;
+    gboolean        descending;
+};
+
+void cscoin_sort_init   (CSCoinSort       *self,
+                         gsize             n_numbers,
+                         gboolean          descending);
+void cscoin_sort_uint64 (const CSCoinSort *self,
+                         guint64          *numbers,
+                         guint64          *scratch);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_SORT_H__ */
@@ -0,0 +1,297 @@
+#define _GNU_SOURCE
+
+#include "cscoin-team.h"
+#include "cscoin-topology.h"
+
+#if defined(__linux__)
+#define CSCOIN_TEAM_HAVE_AFFINITY 1
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CSCOIN_TEAM_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+/* idle members keep polling for this long after a job, so that one posted
+ * right after is picked up at once, then yield their CPU between polls until
+ * the second deadline, and only then sleep */
+#define CSCOIN_TEAM_SPIN_DURATION  (G_TIME_SPAN_MILLISECOND / 10)
+#define CSCOIN_TEAM_YIELD_DURATION (3 * G_TIME_SPAN_MILLISECOND / 10)
+
+/* polls between two looks at the clock while spinning */
+#define CSCOIN_TEAM_SPIN_POLLS 64
+
+typedef struct _CSCoinTeamMember CSCoinTeamMember;
+
+struct _CSCoinTeamMember
+{
+    CSCoinTeam *team;
+    guint       index;
+};
+
+typedef struct _CSCoinTeamCancellation CSCoinTeamCancellation;
+
+struct _CSCoinTeamCancellation
+{
+    CSCoinTeam *team;
+    guint       generation;
+};
+
+static inline void
+relax (void)
+{
+#ifdef CSCOIN_TEAM_HAVE_X86
+    _mm_pause ();
+#endif
+}
+
+static void
+pin_member (CSCoinTeam *self, guint index)
+{
+#ifdef CSCOIN_TEAM_HAVE_AFFINITY
+    cpu_set_t set;
+
+    if (self->cpus == NULL)
+    {
+        return;
+    }
+
+    CPU_ZERO (&set);
+    CPU_SET (self->cpus[index], &set);
+
+    /* the kernel keeps moving the thread around if this fails */
+    pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+#endif
+}
+
+static void
+wait_for_job (CSCoinTeam *self, guint seen)
+{
+    gint64 start = g_get_monotonic_time ();
+    gint64 elapsed = 0;
+    guint n_polls = 0;
+
+    while (g_atomic_int_get (&self->generation) == seen)
+    {
+        if (elapsed < CSCOIN_TEAM_SPIN_DURATION)
+        {
+            relax ();
+
+            if (++n_polls % CSCOIN_TEAM_SPIN_POLLS == 0)
+            {
+                elapsed = g_get_monotonic_time () - start;
+            }
+
+            continue;
+        }
+
+        if (elapsed < CSCOIN_TEAM_YIELD_DURATION)
+        {
+            g_thread_yield ();
+            elapsed = g_get_monotonic_time () - start;
+            continue;
+        }
+
+        /* the poster only takes the lock to wake sleepers it counted, and
+         * looks at the generation after counting, so none is missed */
+        g_mutex_lock (&self->mutex);
+        g_atomic_int_inc (&self->n_sleeping);
+
+        while (g_atomic_int_get (&self->generation) == seen)
+        {
+            g_cond_wait (&self->wake_cond, &self->mutex);
+        }
+
+        g_atomic_int_add (&self->n_sleeping, -1);
+        g_mutex_unlock (&self->mutex);
+    }
+}
+
+static gpointer
+member_main (gpointer data)
+{
+    CSCoinTeamMember *member = data;
+    CSCoinTeam *self = member->team;
+    guint index = member->index;
+    guint seen = 0;
+
+    /* pinned before anything else, so that all the memory the member
+     * touches first is placed on its node */
+    pin_member (self, index);
+
+    g_free (member);
+
+    for (;;)
+    {
+        wait_for_job (self, seen);
+
+        /* jobs never overlap, so this is the one that was just posted */
+        seen = g_atomic_int_get (&self->generation);
+
+        /* an empty job dismisses the team */
+        if (self->func == NULL)
+        {
+            break;
+        }
+
+        self->func (self->data, index);
+
+        if (g_atomic_int_dec_and_test (&self->n_running))
+        {
+            g_mutex_lock (&self->mutex);
+            g_cond_broadcast (&self->done_cond);
+            g_mutex_unlock (&self->mutex);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Start a team placed as told by 'placement', its members pinned at once,
+ * keeping only the first 'max_threads' of them unless it is 0.
+ */
+CSCoinTeam *
+cscoin_team_new (CSCoinPlacement placement, guint max_threads)
+{
+    CSCoinTeam *self = g_new0 (CSCoinTeam, 1);
+    CSCoinTeamMember *member;
+    guint i;
+
+    self->n_threads = cscoin_topology_place (placement, &self->cpus);
+
+    if (max_threads > 0)
+    {
+        self->n_threads = MIN (self->n_threads, max_threads);
+    }
+
+    self->threads = g_new (GThread *, self->n_threads);
+
+    g_mutex_init (&self->run_mutex);
+    g_mutex_init (&self->mutex);
+    g_cond_init (&self->wake_cond);
+    g_cond_init (&self->done_cond);
+
+    for (i = 0; i < self->n_threads; i++)
+    {
+        member        = g_new (CSCoinTeamMember, 1);
+        member->team  = self;
+        member->index = i;
+
+        self->threads[i] = g_thread_new ("cscoin-solver", member_main, member);
+    }
+
+    return self;
+}
+
+/* dismiss the members once they are done with the job at hand */
+void
+cscoin_team_free (CSCoinTeam *self)
+{
+    guint i;
+
+    g_mutex_lock (&self->run_mutex);
+
+    self->func = NULL;
+    self->data = NULL;
+
+    g_mutex_lock (&self->mutex);
+    g_atomic_int_inc (&self->generation);
+    g_cond_broadcast (&self->wake_cond);
+    g_mutex_unlock (&self->mutex);
+
+    for (i = 0; i < self->n_threads; i++)
+    {
+        g_thread_join (self->threads[i]);
+    }
+
+    g_mutex_unlock (&self->run_mutex);
+
+    g_mutex_clear (&self->run_mutex);
+    g_mutex_clear (&self->mutex);
+    g_cond_clear (&self->wake_cond);
+    g_cond_clear (&self->done_cond);
+    g_free (self->threads);
+    g_free (self->cpus);
+    g_free (self);
+}
+
+guint
+cscoin_team_get_n_threads (CSCoinTeam *self)
+{
+    return self->n_threads;
+}
+
+static void
+on_cancelled (GCancellable *cancellable, gpointer data)
+{
+    CSCoinTeamCancellation *cancellation = data;
+
+    g_atomic_int_set (&cancellation->team->retired, cancellation->generation);
+}
+
+/*
+ * Run 'func' on every member at once and return when all of them have.
+ * Cancelling 'cancellable' in the meantime only retires this job, which
+ * 'func' finds out through cscoin_team_is_cancelled.
+ */
+void
+cscoin_team_run (CSCoinTeam     *self,
+                 CSCoinTeamFunc  func,
+                 gpointer        data,
+                 GCancellable   *cancellable)
+{
+    CSCoinTeamCancellation cancellation;
+    gulong handler = 0;
+
+    g_mutex_lock (&self->run_mutex);
+
+    self->func = func;
+    self->data = data;
+    g_atomic_int_set (&self->n_running, self->n_threads);
+
+    /* jobs are posted one at a time, so this one gets the next generation,
+     * and it may be retired before the members even see it */
+    cancellation.team       = self;
+    cancellation.generation = g_atomic_int_get (&self->generation) + 1;
+
+    if (cancellable != NULL)
+    {
+        handler = g_cancellable_connect (cancellable, G_CALLBACK (on_cancelled), &cancellation, NULL);
+    }
+
+    /* a full barrier, so the mailbox is seen before the new generation */
+    g_atomic_int_inc (&self->generation);
+
+    if (g_atomic_int_get (&self->n_sleeping) > 0)
+    {
+        g_mutex_lock (&self->mutex);
+        g_cond_broadcast (&self->wake_cond);
+        g_mutex_unlock (&self->mutex);
+    }
+
+    g_mutex_lock (&self->mutex);
+
+    while (g_atomic_int_get (&self->n_running) > 0)
+    {
+        g_cond_wait (&self->done_cond, &self->mutex);
+    }
+
+    g_mutex_unlock (&self->mutex);
+
+    if (handler != 0)
+    {
+        g_cancellable_disconnect (cancellable, handler);
+    }
+
+    g_mutex_unlock (&self->run_mutex);
+}
+
+/* whether the job being run was cancelled, for its members to poll */
+gboolean
+cscoin_team_is_cancelled (CSCoinTeam *self)
+{
+    return g_atomic_int_get (&self->retired) == g_atomic_int_get (&self->generation);
+}
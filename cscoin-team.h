@@ -0,0 +1,57 @@
+#ifndef __CSCOIN_TEAM_H__
+#define __CSCOIN_TEAM_H__
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "cscoin-placement.h"
+
+G_BEGIN_DECLS
+
+/* 'index' tells the members of the team apart, from 0 to 'n_threads - 1' */
+typedef void (*CSCoinTeamFunc) (gpointer data, guint index);
+
+typedef struct _CSCoinTeam CSCoinTeam;
+
+/*
+ * Threads that live until the team is freed, each pinned to its own CPU
+ * unless the placement says otherwise, and run one job at a time all
+ * together.
+ *
+ * A job is posted in the mailbox, 'func' and 'data', and published by
+ * bumping 'generation', which idle members poll without locking for a
+ * while before they sleep on 'wake_cond'. Cancelling a job retires its
+ * generation into 'retired', which the members poll the same way.
+ */
+struct _CSCoinTeam
+{
+    GThread        **threads;
+    guint            n_threads;
+    gint            *cpus;
+
+    GMutex           run_mutex;
+    CSCoinTeamFunc   func;
+    gpointer         data;
+    guint            generation;
+    guint            retired;
+    gint             n_running;
+    gint             n_sleeping;
+
+    GMutex           mutex;
+    GCond            wake_cond;
+    GCond            done_cond;
+};
+
+CSCoinTeam * cscoin_team_new            (CSCoinPlacement  placement,
+                                         guint            max_threads);
+void         cscoin_team_free           (CSCoinTeam      *self);
+guint        cscoin_team_get_n_threads  (CSCoinTeam      *self);
+void         cscoin_team_run            (CSCoinTeam      *self,
+                                         CSCoinTeamFunc   func,
+                                         gpointer         data,
+                                         GCancellable    *cancellable);
+gboolean     cscoin_team_is_cancelled   (CSCoinTeam      *self);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_TEAM_H__ */
@@ -0,0 +1,79 @@
+#include "cscoin-telemetry.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CSCOIN_TELEMETRY_HAVE_X86 1
+#include <x86intrin.h>
+#endif
+
+/* how long the cycle counter is watched against the clock to tell its rate */
+#define CSCOIN_TELEMETRY_CALIBRATION_DURATION (20 * G_TIME_SPAN_MILLISECOND)
+
+static const gchar *
+STAGE_NAMES[CSCOIN_TELEMETRY_N_STAGES] =
+{
+    "seed",
+    "mt64",
+    "sort",
+    "grid-generation",
+    "pathfinding",
+    "format",
+    "checksum"
+};
+
+const gchar *
+cscoin_telemetry_stage_get_name (CSCoinTelemetryStage stage)
+{
+    g_return_val_if_fail (stage < CSCOIN_TELEMETRY_N_STAGES, NULL);
+
+    return STAGE_NAMES[stage];
+}
+
+/* the time stamp counter where there is one, and nanoseconds otherwise */
+guint64
+cscoin_telemetry_get_cycles (void)
+{
+#ifdef CSCOIN_TELEMETRY_HAVE_X86
+    return __rdtsc ();
+#else
+    return g_get_monotonic_time () * 1000;
+#endif
+}
+
+/* measured on first use, which blocks for a little while */
+gdouble
+cscoin_telemetry_get_cycles_per_second (void)
+{
+    static gsize cycles_per_second = 0;
+    gint64 started, elapsed;
+    guint64 started_cycles;
+
+    if (g_once_init_enter (&cycles_per_second))
+    {
+        started        = g_get_monotonic_time ();
+        started_cycles = cscoin_telemetry_get_cycles ();
+
+        g_usleep (CSCOIN_TELEMETRY_CALIBRATION_DURATION);
+
+        elapsed = g_get_monotonic_time () - started;
+
+        g_once_init_leave (&cycles_per_second,
+                           MAX ((cscoin_telemetry_get_cycles () - started_cycles) * G_USEC_PER_SEC / elapsed, 1));
+    }
+
+    return cycles_per_second;
+}
+
+void
+cscoin_telemetry_add (CSCoinTelemetry *self, const CSCoinTelemetry *other)
+{
+    gint stage;
+
+    /* 'other' may belong to a worker that is still counting */
+    self->n_nonces         += __atomic_load_n (&other->n_nonces, __ATOMIC_RELAXED);
+    self->n_sampled_nonces += __atomic_load_n (&other->n_sampled_nonces, __ATOMIC_RELAXED);
+
+    for (stage = 0; stage < CSCOIN_TELEMETRY_N_STAGES; stage++)
+    {
+        self->stage_cycles[stage] += __atomic_load_n (&other->stage_cycles[stage], __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef __CSCOIN_TELEMETRY_H__
+#define __CSCOIN_TELEMETRY_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* one batch of nonces in this many is timed stage by stage */
+#define CSCOIN_TELEMETRY_SAMPLE_PERIOD 16
+
+typedef enum _CSCoinTelemetryStage CSCoinTelemetryStage;
+
+/*
+ * The MT64 draws of the shortest path challenge are part of the grid
+ * generation, and writing out the coordinates of its path is part of the
+ * pathfinding.
+ */
+enum _CSCoinTelemetryStage
+{
+    CSCOIN_TELEMETRY_STAGE_SEED,
+    CSCOIN_TELEMETRY_STAGE_MT64,
+    CSCOIN_TELEMETRY_STAGE_SORT,
+    CSCOIN_TELEMETRY_STAGE_GRID_GENERATION,
+    CSCOIN_TELEMETRY_STAGE_PATHFINDING,
+    CSCOIN_TELEMETRY_STAGE_FORMAT,
+    CSCOIN_TELEMETRY_STAGE_CHECKSUM,
+    CSCOIN_TELEMETRY_N_STAGES
+};
+
+typedef struct _CSCoinTelemetry CSCoinTelemetry;
+
+/*
+ * Counters kept by each worker on its own and summed when read. Only the
+ * nonces of the sampled batches are timed, so 'stage_cycles' divided by
+ * 'n_sampled_nonces' is what a nonce takes on average in each stage.
+ *
+ * Other threads read the counters while the worker updates them, so both
+ * sides go through relaxed atomics: each counter is read whole, though not
+ * necessarily at the same instant as the others.
+ */
+struct _CSCoinTelemetry
+{
+    guint64 n_nonces;
+    guint64 n_sampled_nonces;
+    guint64 stage_cycles[CSCOIN_TELEMETRY_N_STAGES];
+};
+
+const gchar * cscoin_telemetry_stage_get_name        (CSCoinTelemetryStage   stage);
+
+guint64       cscoin_telemetry_get_cycles            (void);
+gdouble       cscoin_telemetry_get_cycles_per_second (void);
+
+void          cscoin_telemetry_add                   (CSCoinTelemetry       *self,
+                                                      const CSCoinTelemetry *other);
+
+/* only the worker that owns 'counter' may add to it */
+static inline void
+cscoin_telemetry_count (guint64 *counter, guint64 value)
+{
+    __atomic_store_n (counter, __atomic_load_n (counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+G_END_DECLS
+
+#endif /* __CSCOIN_TELEMETRY_H__ */
@@ -0,0 +1,185 @@
+#define _GNU_SOURCE
+
+#include "cscoin-topology.h"
+
+#include <stdlib.h>
+
+#if defined(__linux__)
+#define CSCOIN_TOPOLOGY_HAVE_SYSFS 1
+#include <sched.h>
+#endif
+
+#ifdef CSCOIN_TOPOLOGY_HAVE_SYSFS
+
+static gint
+read_cpu_attribute (gint cpu, const gchar *name)
+{
+    gchar *path = g_strdup_printf ("/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+    gchar *contents;
+    gint ret = -1;
+
+    if (g_file_get_contents (path, &contents, NULL, NULL))
+    {
+        ret = g_ascii_strtoll (contents, NULL, 10);
+        g_free (contents);
+    }
+
+    g_free (path);
+
+    return ret;
+}
+
+/* the node of a CPU shows up as a 'node<N>' link in its directory */
+static gint
+read_cpu_node (gint cpu)
+{
+    gchar *path = g_strdup_printf ("/sys/devices/system/cpu/cpu%d", cpu);
+    GDir *dir = g_dir_open (path, 0, NULL);
+    const gchar *name;
+    gchar *end;
+    gint ret = -1;
+
+    g_free (path);
+
+    if (dir == NULL)
+    {
+        return -1;
+    }
+
+    while (ret == -1 && (name = g_dir_read_name (dir)) != NULL)
+    {
+        if (g_str_has_prefix (name, "node") && g_ascii_isdigit (name[4]))
+        {
+            ret = g_ascii_strtoll (name + 4, &end, 10);
+
+            if (*end != '\0')
+            {
+                ret = -1;
+            }
+        }
+    }
+
+    g_dir_close (dir);
+
+    return ret;
+}
+
+#endif
+
+/* CPUs of a node come together, and so do the siblings of a core */
+static gint
+compare_cpus (gconstpointer a, gconstpointer b)
+{
+    const CSCoinTopologyCPU *cpu_a = a;
+    const CSCoinTopologyCPU *cpu_b = b;
+
+    if (cpu_a->node != cpu_b->node)
+    {
+        return cpu_a->node < cpu_b->node ? -1 : 1;
+    }
+
+    if (cpu_a->package != cpu_b->package)
+    {
+        return cpu_a->package < cpu_b->package ? -1 : 1;
+    }
+
+    if (cpu_a->core != cpu_b->core)
+    {
+        return cpu_a->core < cpu_b->core ? -1 : 1;
+    }
+
+    if (cpu_a->cpu != cpu_b->cpu)
+    {
+        return cpu_a->cpu < cpu_b->cpu ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/*
+ * The CPUs the process may run on, in topology order, or none if the
+ * system cannot tell which those are.
+ */
+guint
+cscoin_topology_list_cpus (CSCoinTopologyCPU **cpus)
+{
+#ifdef CSCOIN_TOPOLOGY_HAVE_SYSFS
+    cpu_set_t set;
+    guint n_cpus = 0;
+    gint cpu;
+
+    if (sched_getaffinity (0, sizeof (set), &set) == 0 && CPU_COUNT (&set) > 0)
+    {
+        *cpus = g_new (CSCoinTopologyCPU, CPU_COUNT (&set));
+
+        for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET (cpu, &set))
+            {
+                (*cpus)[n_cpus].cpu     = cpu;
+                (*cpus)[n_cpus].node    = read_cpu_node (cpu);
+                (*cpus)[n_cpus].package = read_cpu_attribute (cpu, "physical_package_id");
+                (*cpus)[n_cpus].core    = read_cpu_attribute (cpu, "core_id");
+                n_cpus++;
+            }
+        }
+
+        qsort (*cpus, n_cpus, sizeof (CSCoinTopologyCPU), compare_cpus);
+
+        return n_cpus;
+    }
+#endif
+
+    *cpus = NULL;
+
+    return 0;
+}
+
+/*
+ * The CPUs to pin the workers to under 'placement', one worker each, or
+ * NULL in 'cpus' if they are left to the scheduler of the system, in which
+ * case there are as many workers as it has CPUs.
+ */
+guint
+cscoin_topology_place (CSCoinPlacement placement, gint **cpus)
+{
+    CSCoinTopologyCPU *topology;
+    guint n_cpus = cscoin_topology_list_cpus (&topology);
+    guint n_placed = 0;
+    guint i;
+
+    if (n_cpus == 0)
+    {
+        *cpus = NULL;
+        return g_get_num_processors ();
+    }
+
+    if (placement == CSCOIN_PLACEMENT_UNPINNED)
+    {
+        g_free (topology);
+        *cpus = NULL;
+        return n_cpus;
+    }
+
+    *cpus = g_new (gint, n_cpus);
+
+    for (i = 0; i < n_cpus; i++)
+    {
+        /* hyperthreads share the hashing and multiplying units of their
+         * core, so only the first of its siblings gets a worker; the core
+         * numbers only tell siblings apart within a package */
+        if (placement == CSCOIN_PLACEMENT_PHYSICAL_CORES && i > 0 && topology[i].core != -1 &&
+            topology[i].core == topology[i - 1].core &&
+            topology[i].package == topology[i - 1].package &&
+            topology[i].node == topology[i - 1].node)
+        {
+            continue;
+        }
+
+        (*cpus)[n_placed++] = topology[i].cpu;
+    }
+
+    g_free (topology);
+
+    return n_placed;
+}
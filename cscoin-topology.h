@@ -0,0 +1,27 @@
+#ifndef __CSCOIN_TOPOLOGY_H__
+#define __CSCOIN_TOPOLOGY_H__
+
+#include <glib.h>
+
+#include "cscoin-placement.h"
+
+G_BEGIN_DECLS
+
+typedef struct _CSCoinTopologyCPU CSCoinTopologyCPU;
+
+/* where a logical CPU sits, -1 for what the system does not tell */
+struct _CSCoinTopologyCPU
+{
+    gint cpu;
+    gint node;
+    gint package;
+    gint core;
+};
+
+guint cscoin_topology_list_cpus  (CSCoinTopologyCPU **cpus);
+guint cscoin_topology_place      (CSCoinPlacement     placement,
+                                  gint              **cpus);
+
+G_END_DECLS
+
+#endif /* __CSCOIN_TOPOLOGY_H__ */
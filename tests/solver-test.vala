@@ -7,6 +7,138 @@ int main (string[] args)
 {
 	Test.init (ref args);
 
+	Test.add_func ("/sha256/seed_batch", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+		var midstate = CSCoin.SHA256Midstate (last_solution_hash);
+
+		/* enough nonces to leave a partial batch on every kernel */
+		var nonces = new string[37];
+		for (var i = 0; i < nonces.length; i++) {
+			nonces[i] = (uint64.MAX / nonces.length * i).to_string ();
+		}
+
+		var seeds = new uint64[nonces.length];
+		midstate.seed_batch (nonces, seeds);
+
+		for (var i = 0; i < nonces.length; i++) {
+			var seed_str = Checksum.compute_for_string (ChecksumType.SHA256, last_solution_hash + nonces[i]);
+			var seed = uint64.parse ("0x" + seed_str[14:16] + seed_str[12:14] + seed_str[10:12] + seed_str[8:10] + seed_str[6:8] + seed_str[4:6] + seed_str[2:4] + seed_str[0:2]);
+			assert (seeds[i] == seed);
+		}
+	});
+
+	Test.add_func ("/mt64", () => {
+		var mt64 = new CSCoin.MT64 ();
+
+		/* cover a few twists, and blocks that straddle them */
+		for (uint64 seed = 0; seed < 10; seed++) {
+			init_genrand64 (seed);
+			mt64.set_seed (seed);
+			for (var i = 0; i < 1000; i++) {
+				assert (mt64.next_uint64 () == genrand64_int64 ());
+			}
+
+			/* a short block only derives part of the state */
+			init_genrand64 (seed);
+			mt64.set_seed (seed);
+			var first_numbers = new uint64[20];
+			mt64.fill_uint64 (first_numbers);
+			foreach (var num in first_numbers) {
+				assert (num == genrand64_int64 ());
+			}
+			for (var i = 0; i < 1000; i++) {
+				assert (mt64.next_uint64 () == genrand64_int64 ());
+			}
+
+			init_genrand64 (seed);
+			mt64.set_seed (seed);
+			var numbers = new uint64[100];
+			for (var j = 0; j < 10; j++) {
+				mt64.fill_uint64 (numbers);
+				foreach (var num in numbers) {
+					assert (num == genrand64_int64 ());
+				}
+			}
+		}
+	});
+
+	Test.add_func ("/mt64xn", () => {
+		var mt64xn = CSCoin.MT64xN ();
+
+		var seeds = new uint64[CSCoin.MT64xN.LANES];
+		for (var lane = 0; lane < seeds.length; lane++) {
+			seeds[lane] = lane * 1000;
+		}
+
+		mt64xn.set_seeds (seeds);
+
+		/* more than a whole state, so that every lane goes through a second twist */
+		var numbers = new uint64[CSCoin.MT64xN.LANES * 400];
+		mt64xn.fill_uint64 (numbers, 400);
+
+		for (var lane = 0; lane < seeds.length; lane++) {
+			init_genrand64 (seeds[lane]);
+			for (var i = 0; i < 400; i++) {
+				assert (numbers[lane * 400 + i] == genrand64_int64 ());
+			}
+		}
+	});
+
+	Test.add_func ("/format", () => {
+		var str = new char[CSCoin.FORMAT_UINT64_MAX_LENGTH + 1];
+
+		/* every digit count, on both sides of each power of ten */
+		for (uint64 power = 1; power <= uint64.MAX / 10; power *= 10) {
+			foreach (var value in new uint64[] {power - 1, power, power + 1, power * 10 - 1}) {
+				str[CSCoin.format_uint64 (value, str)] = '\0';
+				assert ((string) str == value.to_string ());
+			}
+		}
+
+		str[CSCoin.format_uint64 (uint64.MAX, str)] = '\0';
+		assert ((string) str == uint64.MAX.to_string ());
+
+		init_genrand64 (0);
+		var numbers = new uint64[100];
+		var expected = new StringBuilder ();
+		for (var i = 0; i < numbers.length; i++) {
+			numbers[i] = genrand64_int64 () >> (i % 64);
+			expected.append (numbers[i].to_string ());
+		}
+
+		var digits = new char[numbers.length * CSCoin.FORMAT_UINT64_MAX_LENGTH + 1];
+		digits[CSCoin.format_uint64_array (numbers, digits)] = '\0';
+		assert ((string) digits == expected.str);
+	});
+
+	Test.add_func ("/sort", () => {
+		init_genrand64 (0);
+
+		/* sizes that land on each kernel whatever the backend thresholds */
+		foreach (var n_numbers in new size_t[] {1, 2, 7, 20, 100, 1000, 50000}) {
+			foreach (var descending in new bool[] {false, true}) {
+				var sort = CSCoin.Sort (n_numbers, descending);
+				var numbers = new uint64[n_numbers];
+				var scratch = new uint64[sort.scratch_length];
+
+				uint64 sum = 0;
+				for (var i = 0; i < numbers.length; i++) {
+					/* duplicates and the largest key, which the bitonic network pads with */
+					numbers[i] = i % 5 == 3 ? numbers[i / 2] : (i % 7 == 0 ? uint64.MAX : genrand64_int64 ());
+					sum += numbers[i];
+				}
+
+				sort.sort_uint64 (numbers, scratch);
+
+				for (var i = 1; i < numbers.length; i++) {
+					assert (descending ? numbers[i - 1] >= numbers[i] : numbers[i - 1] <= numbers[i]);
+					sum -= numbers[i];
+				}
+				assert (sum == numbers[0]);
+			}
+		}
+	});
+
 	Test.add_func ("/sorted_list", () => {
 		var hash_prefix = "768e";
 		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
@@ -34,6 +166,38 @@ int main (string[] args)
 		assert (checksum.get_string ().has_prefix (hash_prefix));
 	});
 
+	Test.add_func ("/sorted_list/odometer", () => {
+		var hash_prefix = "768e";
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+		var nonce = CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, hash_prefix, CSCoin.ChallengeParameters () {nb_elements = 20}, CSCoin.NonceStrategy.ODOMETER);
+
+		/* the odometer only walks nonces of the same length */
+		assert (nonce.length == 20);
+
+		var seed_str = Checksum.compute_for_string (ChecksumType.SHA256, last_solution_hash + nonce);
+		var seed = uint64.parse ("0x" + seed_str[14:16] + seed_str[12:14] + seed_str[10:12] + seed_str[8:10] + seed_str[6:8] + seed_str[4:6] + seed_str[2:4] + seed_str[0:2]);
+
+		init_genrand64 (seed);
+
+		var numbers = new uint64[20];
+		for (var i = 0; i < numbers.length; i++) {
+			numbers[i] = genrand64_int64 ();
+		}
+
+		var sort = CSCoin.Sort (numbers.length, false);
+		var scratch = new uint64[sort.scratch_length];
+		sort.sort_uint64 (numbers, scratch);
+
+		var checksum = new Checksum (ChecksumType.SHA256);
+
+		foreach (var num in numbers) {
+			var num_str = num.to_string ();
+			checksum.update (num_str.data, num_str.length);
+		}
+
+		assert (checksum.get_string ().has_prefix (hash_prefix));
+	});
+
 	Test.add_func ("/reverse_sorted_list", () => {
 		var hash_prefix = "768e";
 		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
@@ -61,10 +225,310 @@ int main (string[] args)
 		assert (checksum.get_string ().has_prefix (hash_prefix));
 	});
 
+	Test.add_func ("/cancellation", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+		var cancellable = new Cancellable ();
+
+		/* the job is retired before the team even picks it up */
+		cancellable.cancel ();
+
+		try {
+			CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = 20}, CSCoin.NonceStrategy.SCRAMBLE, cancellable);
+			assert_not_reached ();
+		} catch (IOError.CANCELLED err) {
+		} catch (Error err) {
+			assert_not_reached ();
+		}
+	});
+
+	Test.add_func ("/cancellation/running", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+		var cancellable = new Cancellable ();
+
+		/* long lists take far longer than this to solve */
+		var canceller = new Thread<void> ("canceller", () => {
+			Thread.usleep (10000);
+			cancellable.cancel ();
+		});
+
+		try {
+			CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = 10000}, CSCoin.NonceStrategy.SCRAMBLE, cancellable);
+			assert_not_reached ();
+		} catch (IOError.CANCELLED err) {
+		} catch (Error err) {
+			assert_not_reached ();
+		}
+
+		canceller.join ();
+
+		/* the team is ready for the next challenge right away */
+		assert (CSCoin.solve_challenge (1, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = 20}) != null);
+	});
+
+	Test.add_func ("/placement", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		CSCoin.set_placement (CSCoin.Placement.ALL_THREADS);
+		var n_threads = CSCoin.get_n_workers ();
+
+		/* siblings of a core share a single worker */
+		CSCoin.set_placement (CSCoin.Placement.PHYSICAL_CORES);
+		assert (CSCoin.get_n_workers () > 0);
+		assert (CSCoin.get_n_workers () <= n_threads);
+		assert (CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = 20}) != null);
+		assert (CSCoin.get_solution_hash ().has_prefix ("768e"));
+
+		CSCoin.set_placement (CSCoin.Placement.UNPINNED);
+		assert (CSCoin.get_n_workers () == n_threads);
+		assert (CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = 20}) != null);
+		assert (CSCoin.get_solution_hash ().has_prefix ("768e"));
+
+		CSCoin.set_placement (CSCoin.Placement.ALL_THREADS);
+	});
+
+	Test.add_func ("/telemetry", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		CSCoin.Telemetry before;
+		CSCoin.get_telemetry (out before);
+
+		CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "abcd", CSCoin.ChallengeParameters () {nb_elements = 100});
+
+		CSCoin.Telemetry after;
+		CSCoin.get_telemetry (out after);
+
+		/* finding a four digit prefix takes thousands of tries, some of them timed */
+		assert (after.n_nonces - before.n_nonces >= CSCoin.Telemetry.SAMPLE_PERIOD);
+		assert (after.n_sampled_nonces > before.n_sampled_nonces);
+		assert (after.n_sampled_nonces - before.n_sampled_nonces <= after.n_nonces - before.n_nonces);
+		assert (after.stage_cycles[CSCoin.TelemetryStage.SORT] > before.stage_cycles[CSCoin.TelemetryStage.SORT]);
+		assert (after.stage_cycles[CSCoin.TelemetryStage.PATHFINDING] == before.stage_cycles[CSCoin.TelemetryStage.PATHFINDING]);
+
+		CSCoin.Telemetry worker_telemetry;
+		assert (CSCoin.get_worker_telemetry (0, out worker_telemetry));
+		assert (!CSCoin.get_worker_telemetry (CSCoin.get_n_workers (), out worker_telemetry));
+	});
+
+	Test.add_func ("/prepare_challenge", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = 20});
+
+		/* the hash of the solution is where the next challenge starts */
+		var solution_hash = CSCoin.get_solution_hash ();
+		assert (solution_hash != null);
+		assert (solution_hash.has_prefix ("768e"));
+
+		CSCoin.prepare_challenge (solution_hash, CSCoin.ChallengeType.SORTED_LIST, CSCoin.ChallengeParameters () {nb_elements = 20});
+
+		var nonce = CSCoin.solve_challenge (1, CSCoin.ChallengeType.SORTED_LIST, solution_hash, "abcd", CSCoin.ChallengeParameters () {nb_elements = 20});
+
+		var seed_str = Checksum.compute_for_string (ChecksumType.SHA256, solution_hash + nonce);
+		var seed = uint64.parse ("0x" + seed_str[14:16] + seed_str[12:14] + seed_str[10:12] + seed_str[8:10] + seed_str[6:8] + seed_str[4:6] + seed_str[2:4] + seed_str[0:2]);
+
+		init_genrand64 (seed);
+
+		var numbers = new SList<uint64?> ();
+		for (var i = 0; i < 20; i++) {
+			numbers.append (genrand64_int64 ());
+		}
+
+		numbers.sort ((a, b) => a < b ? -1 : 1);
+
+		var checksum = new Checksum (ChecksumType.SHA256);
+
+		foreach (var num in numbers) {
+			var num_str = num.to_string ();
+			checksum.update (num_str.data, num_str.length);
+		}
+
+		assert (checksum.get_string () == CSCoin.get_solution_hash ());
+	});
+
+	Test.add_func ("/memory_budget", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		/* a single 1000x1000 grid takes well over a megabyte */
+		CSCoin.set_memory_budget (1024 * 1024);
+
+		try {
+			CSCoin.solve_challenge (0, CSCoin.ChallengeType.SHORTEST_PATH, last_solution_hash, "768e", CSCoin.ChallengeParameters () {grid_size = 1000, nb_blockers = 10});
+			assert_not_reached ();
+		} catch (IOError.NO_SPACE err) {
+		} catch (Error err) {
+			assert_not_reached ();
+		}
+
+		CSCoin.set_memory_budget (0);
+	});
+
+	Test.add_func ("/memory_budget/unbounded", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		/* sixteen lanes of this many numbers would wrap a 32-bit size around,
+		 * and no budget stands in the way */
+		CSCoin.set_memory_budget (0);
+
+		try {
+			CSCoin.solve_challenge (0, CSCoin.ChallengeType.SORTED_LIST, last_solution_hash, "768e", CSCoin.ChallengeParameters () {nb_elements = (1 << 28) + 1});
+			assert_not_reached ();
+		} catch (IOError.INVALID_ARGUMENT err) {
+		} catch (Error err) {
+			assert_not_reached ();
+		}
+	});
+
 	Test.add_func ("/shortest_path", () => {
 		var hash_prefix = "768e";
 		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
-		var nonce = CSCoin.solve_challenge (0, CSCoin.ChallengeType.SHORTEST_PATH, last_solution_hash, hash_prefix, CSCoin.ChallengeParameters () {nb_elements = 20});
+		var grid_size = 20;
+		var nonce = CSCoin.solve_challenge (0, CSCoin.ChallengeType.SHORTEST_PATH, last_solution_hash, hash_prefix, CSCoin.ChallengeParameters () {grid_size = grid_size, nb_blockers = 40});
+
+		var seed_str = Checksum.compute_for_string (ChecksumType.SHA256, last_solution_hash + nonce);
+		var seed = uint64.parse ("0x" + seed_str[14:16] + seed_str[12:14] + seed_str[10:12] + seed_str[8:10] + seed_str[6:8] + seed_str[4:6] + seed_str[2:4] + seed_str[0:2]);
+
+		init_genrand64 (seed);
+
+		/* 0 is blank, 1 is the start, 2 is the end and 3 is a blocker */
+		var grid = new int[grid_size, grid_size];
+		for (var i = 0; i < grid_size; i++) {
+			grid[0, i]             = 3;
+			grid[grid_size - 1, i] = 3;
+			grid[i, 0]             = 3;
+			grid[i, grid_size - 1] = 3;
+		}
+
+		int start_y, start_x, end_y, end_x;
+		do {
+			start_y = (int) (genrand64_int64 () % grid_size);
+			start_x = (int) (genrand64_int64 () % grid_size);
+		} while (grid[start_y, start_x] != 0);
+		grid[start_y, start_x] = 1;
+
+		do {
+			end_y = (int) (genrand64_int64 () % grid_size);
+			end_x = (int) (genrand64_int64 () % grid_size);
+		} while (grid[end_y, end_x] != 0);
+		grid[end_y, end_x] = 2;
+
+		for (var i = 0; i < 40; i++) {
+			var y = (int) (genrand64_int64 () % grid_size);
+			var x = (int) (genrand64_int64 () % grid_size);
+			if (grid[y, x] == 0) {
+				grid[y, x] = 3;
+			}
+		}
+
+		/* distances to the end, then a walk that prefers up, down, left and right in that order */
+		int[] dy = {-1, 1, 0, 0};
+		int[] dx = {0, 0, -1, 1};
+
+		var distances = new int[grid_size, grid_size];
+		for (var y = 0; y < grid_size; y++) {
+			for (var x = 0; x < grid_size; x++) {
+				distances[y, x] = -1;
+			}
+		}
+
+		var queue = new Queue<int> ();
+		distances[end_y, end_x] = 0;
+		queue.push_tail (end_y * grid_size + end_x);
+		while (!queue.is_empty ()) {
+			var cell = queue.pop_head ();
+			for (var k = 0; k < 4; k++) {
+				var y = cell / grid_size + dy[k];
+				var x = cell % grid_size + dx[k];
+				if (grid[y, x] != 3 && distances[y, x] == -1) {
+					distances[y, x] = distances[cell / grid_size, cell % grid_size] + 1;
+					queue.push_tail (y * grid_size + x);
+				}
+			}
+		}
+
+		assert (distances[start_y, start_x] != -1);
+
+		var checksum = new Checksum (ChecksumType.SHA256);
+
+		var path_y = start_y;
+		var path_x = start_x;
+		while (true) {
+			var coordinates = path_y.to_string () + path_x.to_string ();
+			checksum.update (coordinates.data, coordinates.length);
+			if (path_y == end_y && path_x == end_x) {
+				break;
+			}
+			for (var k = 0; k < 4; k++) {
+				if (distances[path_y + dy[k], path_x + dx[k]] == distances[path_y, path_x] - 1) {
+					path_y += dy[k];
+					path_x += dx[k];
+					break;
+				}
+			}
+		}
+
+		assert (checksum.get_string ().has_prefix (hash_prefix));
+	});
+
+	Test.add_func ("/shortest_path/statistics", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		CSCoin.GridStatistics before, after;
+		CSCoin.get_grid_statistics (out before);
+
+		/* this many blockers wall off a fair share of the grids */
+		CSCoin.solve_challenge (0, CSCoin.ChallengeType.SHORTEST_PATH, last_solution_hash, "768e", CSCoin.ChallengeParameters () {grid_size = 20, nb_blockers = 160});
+
+		CSCoin.get_grid_statistics (out after);
+
+		assert (after.n_solved > before.n_solved);
+		assert (after.n_enclosed > before.n_enclosed);
+		assert (after.n_exhausted > before.n_exhausted);
+	});
+
+	Test.add_func ("/shortest_path/oversized", () => {
+		var arena = CSCoin.Arena ();
+		var grid  = CSCoin.Grid ();
+		var mt64  = new CSCoin.MT64 ();
+
+		assert (arena.init (CSCoin.Grid.get_arena_size (200)));
+
+		/* a limit below what the arena already holds keeps it from growing,
+		 * so the searches that outgrow their room are skipped */
+		arena.set_limit (1);
+		grid.init (200, arena);
+
+		for (var i = 0; i < 100; i++) {
+			mt64.set_seed (i);
+			grid.generate (mt64, 200 * 200 / 5);
+			grid.solve ();
+		}
+
+		assert (grid.statistics.n_solved > 0);
+		assert (grid.statistics.n_oversized > 0);
+	});
+
+	Test.add_func ("/shortest_path/variants", () => {
+		var last_solution_hash = Checksum.compute_for_string (ChecksumType.SHA256, "test");
+
+		/* the grid only searches unit moves along the rows and the columns
+		 * until the authority specifies these, so any of their members is
+		 * refused */
+		var variants = new CSCoin.ChallengeParameters[] {
+			CSCoin.ChallengeParameters () {grid_size = 20, nb_blockers = 40, movement = CSCoin.GridMovement.EIGHT_WAY},
+			CSCoin.ChallengeParameters () {grid_size = 20, nb_blockers = 40, move_cost = 10},
+			CSCoin.ChallengeParameters () {grid_size = 20, nb_blockers = 40, diagonal_cost = 14},
+			CSCoin.ChallengeParameters () {grid_size = 20, nb_blockers = 40, max_tile_cost = 9}
+		};
+
+		foreach (var parameters in variants) {
+			try {
+				CSCoin.solve_challenge (0, CSCoin.ChallengeType.SHORTEST_PATH, last_solution_hash, "768e", parameters);
+				assert_not_reached ();
+			} catch (IOError.NOT_SUPPORTED err) {
+			} catch (Error err) {
+				assert_not_reached ();
+			}
+		}
 	});
 
 	return Test.run ();